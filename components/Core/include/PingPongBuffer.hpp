@@ -0,0 +1,77 @@
+#pragma once
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// 乒乓双缓冲：生产者逐点直接写入消费者下一块要处理的缓冲区，写满一块后用一次任务通知交给消费者
+// 消费者处理第 k 块的同时，生产者在另一块里继续采集第 k+1 块，中间没有任何拷贝
+// 消费者还没归还上一块时生产者又写满一块，则丢弃这一块（计入 overruns）而不是阻塞生产者
+// C 个通道按结构数组 (SoA) 存放：一块内通道 c 的 N 个样本连续，起始于 block + c * N
+template <typename T, size_t N, size_t C = 1>
+class PingPongBuffer {
+public:
+    PingPongBuffer() { };
+    ~PingPongBuffer() { };
+
+    void set_consumer(TaskHandle_t consumer) { consumer_.store(consumer); }
+
+    // 生产者：写入一个样本，返回 true 表示刚好交出了一整块
+    bool write(const T& value)
+    {
+        static_assert(C == 1, "use write_channels() for multi-channel buffers");
+        return write_channels(&value);
+    }
+
+    // 生产者：写入同一时刻 C 个通道的样本
+    bool write_channels(const T* values)
+    {
+        for (size_t c = 0; c < C; c++) {
+            buffers_[write_idx_][c][write_pos_] = values[c];
+        }
+        write_pos_++;
+        samples_written_.fetch_add(1, std::memory_order_relaxed);
+        if (write_pos_ < N) {
+            return false;
+        }
+        write_pos_ = 0;
+        TaskHandle_t consumer = consumer_.load();
+        if (consumer == nullptr || busy_idx_.load(std::memory_order_acquire) != NO_BLOCK) {
+            overruns_.fetch_add(1, std::memory_order_relaxed); // 消费者还占着另一块，本块作废重写
+            return false;
+        }
+        busy_idx_.store(write_idx_, std::memory_order_release);
+        write_idx_ ^= 1;
+        xTaskNotifyGive(consumer);
+        return true;
+    }
+
+    // 消费者：等待一整块，超时返回 nullptr；处理完必须调用 release_block()
+    const T* wait_block(TickType_t ticks_to_wait)
+    {
+        if (ulTaskNotifyTake(pdTRUE, ticks_to_wait) == 0) {
+            return nullptr;
+        }
+        int idx = busy_idx_.load(std::memory_order_acquire);
+        return (idx == NO_BLOCK) ? nullptr : buffers_[idx][0];
+    }
+
+    void release_block() { busy_idx_.store(NO_BLOCK, std::memory_order_release); }
+
+    uint32_t get_samples_written() const { return samples_written_.load(std::memory_order_relaxed); }
+    uint32_t get_overruns() const { return overruns_.load(std::memory_order_relaxed); }
+    static constexpr size_t block_size() { return N; }
+    static constexpr size_t channels() { return C; }
+
+private:
+    static constexpr int NO_BLOCK = -1;
+
+    alignas(16) T buffers_[2][C][N];
+    int write_idx_ = 0; // 只由生产者访问
+    size_t write_pos_ = 0; // 只由生产者访问
+    std::atomic<int> busy_idx_ { NO_BLOCK }; // 已交给消费者、尚未归还的那一块
+    std::atomic<TaskHandle_t> consumer_ { nullptr };
+    std::atomic<uint32_t> samples_written_ { 0 };
+    std::atomic<uint32_t> overruns_ { 0 };
+};
@@ -0,0 +1,119 @@
+#pragma once
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// 队列满时生产者的处理方式
+struct ChannelPolicy {
+    enum overflow_t {
+        BLOCK = 0, // 最多等待 timeout，超时丢弃新数据；实时生产者的 timeout 不应超过一个采样周期
+        DROP_NEWEST = 1, // 直接丢弃新数据
+        DROP_OLDEST = 2, // 挤掉队首最旧的一条，保留最新数据
+        DECIMATE = 3, // 积压超过一半容量后每 decimation 条只放入一条，满了丢弃新数据
+    };
+    overflow_t overflow;
+    TickType_t timeout;
+    int decimation;
+};
+
+// 生产者到消费者的通道：FreeRTOS 队列加上溢出策略与统计，慢消费者不会拖住实时生产者
+// 单生产者单消费者；统计量用原子变量，任意任务都可以读取
+template <typename T>
+class QueueChannel {
+public:
+    struct Stats {
+        uint32_t produced; // 生产者提交的条数，含被丢弃的
+        uint32_t consumed;
+        uint32_t dropped;
+        uint32_t peak_depth;
+    };
+
+    QueueChannel(size_t depth, const ChannelPolicy& policy)
+        : queue_(xQueueCreate(depth, sizeof(T)))
+        , depth_(depth)
+        , policy_(policy) { };
+    ~QueueChannel() { vQueueDelete(queue_); };
+
+    // 生产者：返回 false 表示这一条 (或按 DROP_OLDEST 挤掉的一条) 被丢弃
+    bool push(const T& item)
+    {
+        produced_.fetch_add(1, std::memory_order_relaxed);
+        bool sent = false;
+        switch (policy_.overflow) {
+        case ChannelPolicy::BLOCK:
+            sent = xQueueSend(queue_, &item, policy_.timeout) == pdTRUE;
+            break;
+        case ChannelPolicy::DROP_NEWEST:
+            sent = xQueueSend(queue_, &item, 0) == pdTRUE;
+            break;
+        case ChannelPolicy::DROP_OLDEST:
+            sent = xQueueSend(queue_, &item, 0) == pdTRUE;
+            if (!sent) {
+                T oldest;
+                const bool evicted = xQueueReceive(queue_, &oldest, 0) == pdTRUE;
+                if (evicted) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                }
+                // 消费者可能同时取走了一条，无论如何这里都有空位
+                sent = xQueueSend(queue_, &item, 0) == pdTRUE;
+                if (sent && evicted) {
+                    update_peak();
+                    return false;
+                }
+            }
+            break;
+        case ChannelPolicy::DECIMATE:
+            if (uxQueueMessagesWaiting(queue_) * 2 >= depth_ && policy_.decimation > 1
+                && ++decimate_count_ % policy_.decimation != 0) {
+                break;
+            }
+            sent = xQueueSend(queue_, &item, 0) == pdTRUE;
+            break;
+        }
+        if (!sent) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        update_peak();
+        return true;
+    }
+
+    // 消费者：等待一条，超时返回 false
+    bool pop(T* item, TickType_t ticks_to_wait)
+    {
+        if (xQueueReceive(queue_, item, ticks_to_wait) != pdTRUE) {
+            return false;
+        }
+        consumed_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    size_t size() const { return uxQueueMessagesWaiting(queue_); }
+    size_t capacity() const { return depth_; }
+    Stats get_stats() const
+    {
+        return { produced_.load(std::memory_order_relaxed), consumed_.load(std::memory_order_relaxed),
+            dropped_.load(std::memory_order_relaxed), peak_depth_.load(std::memory_order_relaxed) };
+    }
+
+private:
+    QueueHandle_t queue_;
+    size_t depth_;
+    ChannelPolicy policy_;
+    uint32_t decimate_count_ = 0; // 只由生产者访问
+    std::atomic<uint32_t> produced_ { 0 };
+    std::atomic<uint32_t> consumed_ { 0 };
+    std::atomic<uint32_t> dropped_ { 0 };
+    std::atomic<uint32_t> peak_depth_ { 0 };
+
+    // 峰值深度只由生产者更新
+    void update_peak()
+    {
+        const uint32_t depth = uxQueueMessagesWaiting(queue_);
+        if (depth > peak_depth_.load(std::memory_order_relaxed)) {
+            peak_depth_.store(depth, std::memory_order_relaxed);
+        }
+    }
+};
@@ -0,0 +1,111 @@
+#pragma once
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// 单生产者单消费者无锁环形缓冲区，用于跨核传递采样数据
+// head 只由生产者写，tail 只由消费者写，两者分处不同缓存行避免伪共享
+// 消费者可设置水位线，数据量达到水位线时生产者用任务通知唤醒消费者，一个块只唤醒一次
+// 休眠握手是 Dekker 式的：消费者写 consumer_waiting_ 后读 head_，生产者写 head_ 后读 consumer_waiting_
+// 两边的写与读之间都要有 seq_cst 栅栏，否则 release/acquire 允许两边都读到旧值，生产者不通知、消费者照样睡下
+template <typename T, size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+    SpscRing() { };
+    ~SpscRing() { };
+
+    // 生产者：批量写入，返回实际写入个数（空间不足时只写一部分）
+    size_t push_n(const T* data, size_t count)
+    {
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        const uint32_t tail = tail_.load(std::memory_order_acquire);
+        const size_t space = N - (head - tail);
+        if (count > space) {
+            count = space;
+        }
+        const size_t offset = head & MASK;
+        const size_t first = (count < N - offset) ? count : N - offset;
+        memcpy(&buffer_[offset], data, first * sizeof(T));
+        memcpy(&buffer_[0], data + first, (count - first) * sizeof(T));
+        head_.store(head + count, std::memory_order_release);
+        notify_if_watermark_reached();
+        return count;
+    }
+
+    bool push(const T& value) { return push_n(&value, 1) == 1; }
+
+    // 消费者：批量读出，返回实际读出个数
+    size_t pop_n(T* out, size_t count)
+    {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        const uint32_t head = head_.load(std::memory_order_acquire);
+        const size_t available = head - tail;
+        if (count > available) {
+            count = available;
+        }
+        const size_t offset = tail & MASK;
+        const size_t first = (count < N - offset) ? count : N - offset;
+        memcpy(out, &buffer_[offset], first * sizeof(T));
+        memcpy(out + first, &buffer_[0], (count - first) * sizeof(T));
+        tail_.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    bool pop(T& value) { return pop_n(&value, 1) == 1; }
+
+    size_t size() const { return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire); }
+    size_t free_space() const { return N - size(); }
+    static constexpr size_t capacity() { return N; }
+
+    // 消费者在开始等待前调用一次，注册自己的任务句柄和唤醒水位线
+    void set_consumer(TaskHandle_t consumer, size_t watermark)
+    {
+        consumer_ = consumer;
+        watermark_ = (watermark == 0) ? 1 : (watermark > N ? N : watermark);
+    }
+
+    // 消费者：阻塞直到缓冲区数据量达到水位线，超时返回 false
+    bool wait(TickType_t ticks_to_wait)
+    {
+        while (size() < watermark_) {
+            consumer_waiting_.store(true);
+            // 置位后再检查一次，防止生产者恰好在置位前写满水位而错过通知；栅栏保证这次读不会排到置位之前
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (size() >= watermark_) {
+                consumer_waiting_.store(false);
+                break;
+            }
+            if (ulTaskNotifyTake(pdTRUE, ticks_to_wait) == 0) {
+                consumer_waiting_.store(false);
+                return size() >= watermark_;
+            }
+        }
+        return true;
+    }
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr uint32_t MASK = N - 1;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> head_ { 0 };
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> tail_ { 0 };
+    alignas(CACHE_LINE_SIZE) std::atomic<bool> consumer_waiting_ { false };
+    TaskHandle_t consumer_ = nullptr;
+    size_t watermark_ = 1;
+    alignas(CACHE_LINE_SIZE) T buffer_[N];
+
+    void notify_if_watermark_reached()
+    {
+        // 与 wait() 里的栅栏配对：要么这里看到 consumer_waiting_ 置位，要么消费者置位后的检查看到新的 head_
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // 先看到 consumer_waiting_ 置位，才能保证读到的 consumer_/watermark_ 已由 set_consumer 写好
+        if (consumer_waiting_.load() && size() >= watermark_ && consumer_waiting_.exchange(false)) {
+            xTaskNotifyGive(consumer_);
+        }
+    }
+};
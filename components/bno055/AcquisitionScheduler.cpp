@@ -0,0 +1,99 @@
+#include "AcquisitionScheduler.hpp"
+#include <string.h>
+
+AcquisitionScheduler::~AcquisitionScheduler()
+{
+    if (timer != nullptr) {
+        esp_timer_stop(timer);
+        esp_timer_delete(timer);
+    }
+}
+
+esp_err_t AcquisitionScheduler::start(TaskHandle_t task)
+{
+    if (rate_hz == 0 || task == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    this->task = task;
+    esp_timer_create_args_t timer_args = {};
+    timer_args.callback = timer_callback;
+    timer_args.arg = this;
+    timer_args.dispatch_method = ESP_TIMER_TASK;
+    timer_args.name = "acq_timer";
+    esp_err_t err = esp_timer_create(&timer_args, &timer);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create acquisition timer: %s", esp_err_to_name(err));
+        return err;
+    }
+    ESP_LOGI(TAG, "acquisition timer started at %" PRIu32 " Hz", rate_hz);
+    return esp_timer_start_periodic(timer, get_period_us());
+}
+
+int64_t AcquisitionScheduler::stamp()
+{
+    int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL(&stats_lock);
+    if (last_stamp_us != 0) {
+        int64_t interval_us = now_us - last_stamp_us;
+        int64_t jitter_us = interval_us - get_period_us();
+        if (jitter_us < 0) {
+            jitter_us = -jitter_us;
+        }
+        int bin = jitter_us / JITTER_BIN_US;
+        if (bin >= JITTER_BINS) {
+            bin = JITTER_BINS - 1;
+        }
+        jitter_histogram[bin]++;
+        if (samples == 0 || interval_us < min_interval_us) {
+            min_interval_us = interval_us;
+        }
+        if (samples == 0 || interval_us > max_interval_us) {
+            max_interval_us = interval_us;
+        }
+        samples++;
+    }
+    last_stamp_us = now_us;
+    portEXIT_CRITICAL(&stats_lock);
+    return now_us;
+}
+
+AcquisitionScheduler::JitterStats AcquisitionScheduler::get_jitter_stats()
+{
+    JitterStats stats = {};
+    uint32_t histogram[JITTER_BINS];
+    portENTER_CRITICAL(&stats_lock);
+    stats.samples = samples;
+    stats.min_interval_us = min_interval_us;
+    stats.max_interval_us = max_interval_us;
+    memcpy(histogram, jitter_histogram, sizeof(histogram));
+    portEXIT_CRITICAL(&stats_lock);
+
+    // 按直方图累计到 99%，取该格的上边界作为 p99
+    uint64_t threshold = ((uint64_t)stats.samples * 99 + 99) / 100;
+    uint64_t cumulative = 0;
+    for (int i = 0; i < JITTER_BINS; i++) {
+        cumulative += histogram[i];
+        if (cumulative >= threshold && cumulative > 0) {
+            stats.p99_jitter_us = (i + 1) * JITTER_BIN_US;
+            break;
+        }
+    }
+    return stats;
+}
+
+void AcquisitionScheduler::reset_jitter_stats()
+{
+    portENTER_CRITICAL(&stats_lock);
+    last_stamp_us = 0;
+    samples = 0;
+    min_interval_us = 0;
+    max_interval_us = 0;
+    memset(jitter_histogram, 0, sizeof(jitter_histogram));
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+void AcquisitionScheduler::timer_callback(void* arg)
+{
+    AcquisitionScheduler* scheduler = static_cast<AcquisitionScheduler*>(arg);
+    xTaskNotifyGive(scheduler->task);
+}
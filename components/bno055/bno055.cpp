@@ -4,6 +4,16 @@
 i2c_master_dev_handle_t Bno055Driver::i2c_master_dev_handle = nullptr;
 i2c_master_bus_handle_t Bno055Driver::i2c_master_bus_handle = nullptr;
 SemaphoreHandle_t Bno055Driver::bno055_mutex = xSemaphoreCreateMutex();
+// 第一个必须是页寄存器，其余寄存器只在第0页有效
+Bno055Driver::ShadowRegister Bno055Driver::shadow_registers[] = {
+    { BNO055_PAGE_ID_ADDR, 0, false },
+    { BNO055_UNIT_SEL_ADDR, 0, false },
+    { BNO055_OPR_MODE_ADDR, 0, false },
+    { BNO055_AXIS_MAP_CONFIG_ADDR, 0, false },
+    { BNO055_AXIS_MAP_SIGN_ADDR, 0, false },
+};
+uint32_t Bno055Driver::shadow_hits = 0;
+uint32_t Bno055Driver::shadow_misses = 0;
 
 esp_err_t Bno055Driver::init()
 {
@@ -16,8 +26,19 @@ esp_err_t Bno055Driver::init()
     i2c_master_init(&i2c_master_bus_handle, &i2c_master_dev_handle); // 初始化i2c总线，挂载bno055
     ESP_LOGI(TAG, "i2c master init success");
     s32 comres = BNO055_ERROR;
+    invalidate_shadow_registers();
     comres = bno055_init(&bno055); // 初始化bno055
-    bno055_set_operation_mode(BNO055_OPERATION_MODE_NDOF); // 设置操作模式为NDOF，即直接读寄存器就可以得到数值
+    bno055_set_euler_unit(BNO055_EULER_UNIT_DEG); // 突发读取不再经过库的单位检查，这里提前固定单位
+    bno055_set_accel_unit(BNO055_ACCEL_UNIT_MSQ);
+    if (profile == PROFILE_VIBRATION) {
+        // 非融合模式下加速度计配置才由用户决定：±4g 量程，1000Hz 带宽
+        bno055_set_accel_range(BNO055_ACCEL_RANGE_4G);
+        bno055_set_accel_bw(BNO055_ACCEL_BW_1000HZ);
+        bno055_set_accel_power_mode(BNO055_ACCEL_NORMAL);
+        bno055_set_operation_mode(BNO055_OPERATION_MODE_ACCONLY);
+    } else {
+        bno055_set_operation_mode(BNO055_OPERATION_MODE_NDOF); // 设置操作模式为NDOF，即直接读寄存器就可以得到数值
+    }
     vTaskDelay(pdMS_TO_TICKS(1000)); // 等待稳定
     if (comres != BNO055_SUCCESS) {
         ESP_LOGE(TAG, "BNO055 init failed with error: %d", comres);
@@ -33,29 +54,71 @@ esp_err_t Bno055Driver::init()
     return ESP_OK;
 }
 
-// 由于bno055被两个线程使用，需要加锁读取保证线程安全
-bno055_euler_double_t Bno055Driver::read_double_euler() {
+// 一次 i2c_master_transmit_receive 读回 0x08~0x33 全部数据寄存器，振动模式下只读加速度部分
+esp_err_t Bno055Driver::read_frame(SensorFrame* frame)
+{
     if (bno055_mutex == NULL) {
         ESP_LOGE(TAG, "bno055 mutex is NULL");
-        return euler;
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (bno055.page_id != BNO055_PAGE_ZERO && bno055_write_page_id(BNO055_PAGE_ZERO) != BNO055_SUCCESS) {
+        return ESP_FAIL;
+    }
+    const int length = (profile == PROFILE_VIBRATION) ? BNO055_ACCEL_FRAME_LENGTH : BNO055_FRAME_LENGTH;
+    u8 raw[BNO055_FRAME_LENGTH];
+    if (bno055read(bno055.dev_addr, BNO055_FRAME_START_ADDR, raw, length) != BNO055_SUCCESS) {
+        return ESP_FAIL;
+    }
+    // 寄存器为小端 LSB/MSB 排列，逐个拼成 s16
+    u8* out = reinterpret_cast<u8*>(frame) + offsetof(SensorFrame, accel);
+    for (int i = 0; i < length; i += 2) {
+        s16 value = (s16)((((s32)((s8)raw[i + 1])) << BNO055_SHIFT_EIGHT_BITS) | raw[i]);
+        memcpy(&out[i], &value, sizeof(value)); // SensorFrame 是 packed 结构，按字节写入避免非对齐访问
     }
-    bno055_convert_double_euler_hpr_deg(&euler);
-    return euler;
+    return ESP_OK;
 }
 
-double Bno055Driver::read_linear_accel_z() {
-    if (bno055_mutex == NULL) {
-        ESP_LOGE(TAG, "bno055 mutex is NULL");
-        return linear_accel_z;
+Bno055Driver::ShadowRegister* Bno055Driver::find_shadow_register(u8 reg_addr)
+{
+    ShadowRegister& page = shadow_registers[0];
+    if (reg_addr == page.addr) {
+        return &page;
+    }
+    // 页号未知或不在第0页时，同一地址对应的不是这些配置寄存器
+    if (!page.valid || page.value != BNO055_PAGE_ZERO) {
+        return nullptr;
+    }
+    for (auto& shadow : shadow_registers) {
+        if (shadow.addr == reg_addr) {
+            return &shadow;
+        }
+    }
+    return nullptr;
+}
+
+void Bno055Driver::invalidate_shadow_registers()
+{
+    for (auto& shadow : shadow_registers) {
+        shadow.valid = false;
     }
-    bno055_convert_double_linear_accel_z_msq(&linear_accel_z);
-    return linear_accel_z;
 }
 
 s8 Bno055Driver::bno055read(u8 dev_addr, u8 reg_addr, u8* reg_data, u8 wr_len)
 {
     xSemaphoreTake(bno055_mutex, portMAX_DELAY);
+    ShadowRegister* shadow = (wr_len == 1) ? find_shadow_register(reg_addr) : nullptr;
+    if (shadow != nullptr && shadow->valid) {
+        *reg_data = shadow->value;
+        shadow_hits++;
+        xSemaphoreGive(bno055_mutex);
+        return BNO055_SUCCESS;
+    }
     esp_err_t err = i2c_master_transmit_receive(i2c_master_dev_handle, &reg_addr, 1, reg_data, wr_len, I2C_MASTER_TIMEOUT_MS);
+    if (shadow != nullptr && err == ESP_OK) {
+        shadow->value = *reg_data;
+        shadow->valid = true;
+        shadow_misses++;
+    }
     xSemaphoreGive(bno055_mutex);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "I2C read failed at register 0x%02X: %s", reg_addr, esp_err_to_name(err));
@@ -76,6 +139,19 @@ s8 Bno055Driver::bno055write(u8 dev_addr, u8 reg_addr, u8* reg_data, u8 wr_len)
     memcpy(&write_buffer[1], reg_data, wr_len);
     xSemaphoreTake(bno055_mutex, portMAX_DELAY);
     esp_err_t err = i2c_master_transmit(i2c_master_dev_handle, write_buffer, wr_len + 1, I2C_MASTER_TIMEOUT_MS);
+    if (err == ESP_OK) {
+        if (reg_addr == BNO055_SYS_TRIGGER_ADDR) {
+            invalidate_shadow_registers(); // 复位等系统触发后寄存器回到默认值
+        } else if (wr_len == 1) {
+            ShadowRegister* shadow = find_shadow_register(reg_addr);
+            if (shadow != nullptr) {
+                shadow->value = reg_data[0];
+                shadow->valid = true;
+            }
+        }
+    } else {
+        invalidate_shadow_registers(); // 写失败后无法确定芯片里的实际值
+    }
     xSemaphoreGive(bno055_mutex);
     free(write_buffer);
     if (err != ESP_OK) {
@@ -107,12 +183,20 @@ void Bno055Driver::i2c_master_init(i2c_master_bus_handle_t* bus_handle, i2c_mast
     ESP_ERROR_CHECK(i2c_master_bus_add_device(*bus_handle, &dev_config, dev_handle));
 }
 
-void Bno055Driver::bno055_euler_queue_push(bno055_euler_double_t euler)
+void Bno055Driver::bno055_euler_queue_push(int64_t timestamp_us, bno055_euler_t euler)
 {
-    xQueueSend(bno055_euler_queue, &euler, portMAX_DELAY);
+    bno055_euler_channel.push({ timestamp_us, euler });
 }
 
-void Bno055Driver::bno055_linear_accel_z_queue_push(double linear_accel_z)
+// 直接写入 DSP 的输入缓冲区；DSP 来不及处理时整块丢弃，不阻塞采集任务
+// 浮点模式下换算成物理量再写入，定点模式下原样写入 s16，比例系数由 DSP 在功率谱阶段统一乘
+void Bno055Driver::bno055_accel_push(s16 x, s16 y, s16 z)
 {
-    xQueueSend(bno055_linear_accel_z_queue, &linear_accel_z, portMAX_DELAY);
+#if DSP_FFT_FIXED_POINT
+    const dsp_sample_t values[DSP_AXES] = { x, y, z };
+#else
+    const float scale = get_accel_scale();
+    const dsp_sample_t values[DSP_AXES] = { x * scale, y * scale, z * scale };
+#endif
+    bno055_accel_blocks.write_channels(values);
 }
\ No newline at end of file
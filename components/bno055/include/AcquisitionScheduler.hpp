@@ -0,0 +1,49 @@
+#pragma once
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdint.h>
+
+// 基于 esp_timer 的采样时钟，采样率与 FreeRTOS tick 无关
+// 定时器回调只负责通知采集任务，时间戳在任务被唤醒时打上，因此抖动统计包含调度延迟
+// 采样率在构造时由采集配置给定，运行中不能更改：DSP 的频率轴、滤波器与基线都按启动时的采样率建立
+class AcquisitionScheduler {
+public:
+    struct JitterStats {
+        uint32_t samples; // 参与统计的采样间隔个数
+        int64_t min_interval_us;
+        int64_t max_interval_us;
+        uint32_t p99_jitter_us; // |实际间隔 - 理论周期| 的 99 分位
+    };
+
+    AcquisitionScheduler(uint32_t rate_hz)
+        : rate_hz(rate_hz) { };
+    ~AcquisitionScheduler();
+
+    esp_err_t start(TaskHandle_t task);
+    uint32_t get_rate_hz() const { return rate_hz; }
+    int64_t get_period_us() const { return 1000000LL / rate_hz; }
+    void wait_next_tick() { ulTaskNotifyTake(pdTRUE, portMAX_DELAY); }
+    int64_t stamp(); // 记录本次采样时刻并更新抖动统计
+    JitterStats get_jitter_stats();
+    void reset_jitter_stats();
+
+private:
+    static constexpr auto TAG = "AcquisitionScheduler";
+    static constexpr uint32_t JITTER_BIN_US = 20; // 直方图每格 20us
+    static constexpr int JITTER_BINS = 64; // 最后一格收纳所有超出范围的抖动
+
+    const uint32_t rate_hz;
+    TaskHandle_t task = nullptr;
+    esp_timer_handle_t timer = nullptr;
+    portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+    int64_t last_stamp_us = 0;
+    uint32_t samples = 0;
+    int64_t min_interval_us = 0;
+    int64_t max_interval_us = 0;
+    uint32_t jitter_histogram[JITTER_BINS] = {};
+
+    static void timer_callback(void* arg);
+};
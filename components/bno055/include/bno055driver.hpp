@@ -6,15 +6,58 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
+#include <stddef.h>
+#include "APPConfig.h"
+#include "PingPongBuffer.hpp"
+#include "QueueChannel.hpp"
 
 extern "C" {
 #include "bno055.h"
 }
 
+// 数据寄存器 0x08~0x33 连续排列，一次突发读取即可拿到一帧完整数据
+#define BNO055_FRAME_START_ADDR BNO055_ACCEL_DATA_X_LSB_ADDR
+#define BNO055_FRAME_LENGTH (BNO055_GRAVITY_DATA_Z_MSB_ADDR - BNO055_ACCEL_DATA_X_LSB_ADDR + 1)
+// 振动模式下只读取加速度计 0x08~0x0D
+#define BNO055_ACCEL_FRAME_LENGTH (BNO055_ACCEL_DATA_Z_MSB_ADDR - BNO055_ACCEL_DATA_X_LSB_ADDR + 1)
+
+// 一帧传感器原始数据，accel 之后的字段顺序与寄存器顺序一致
+struct __attribute__((packed)) SensorFrame {
+    int64_t timestamp_us; // 采样时刻，esp_timer 时间基准
+    bno055_accel_t accel;
+    bno055_mag_t mag;
+    bno055_gyro_t gyro;
+    bno055_euler_t euler;
+    bno055_quaternion_t quaternion;
+    bno055_linear_accel_t linear_accel;
+    bno055_gravity_t gravity;
+};
+static_assert(sizeof(SensorFrame) - offsetof(SensorFrame, accel) == BNO055_FRAME_LENGTH, "SensorFrame must match the BNO055 data register block");
+
+// 一条姿态记录：采样时刻与原始欧拉角计数，时间戳随数据一起入队，不受消费者出队延迟影响
+struct EulerRecord {
+    int64_t timestamp_us; // 采样时刻，esp_timer 时间基准
+    bno055_euler_t euler;
+};
+
+// 送给 DSP 的样本类型：定点 FFT 模式下直接是原始寄存器值，否则是换算后的物理量
+#if DSP_FFT_FIXED_POINT
+using dsp_sample_t = int16_t;
+#else
+using dsp_sample_t = float;
+#endif
+
 class Bno055Driver {
 public:
+    // 采集配置：融合模式输出姿态，振动模式只高速采集原始加速度
+    enum acquisition_profile_t {
+        PROFILE_FUSION = 0, // NDOF，融合输出上限 100Hz
+        PROFILE_VIBRATION = 1, // ACCONLY，加速度计带宽 1000Hz，由总线速度决定采样率
+    };
+
     // 构造函数
-    Bno055Driver()
+    Bno055Driver(acquisition_profile_t profile = PROFILE_FUSION)
+        : profile(profile)
     {
         bno055.bus_read = bno055read;
         bno055.bus_write = bno055write;
@@ -24,27 +67,54 @@ public:
 
     ~Bno055Driver() { };
 
+    // 原始 s16 到物理量的比例系数，单位在 init 中固定，只在数据流的末端乘一次
+    static constexpr float EULER_SCALE_DEG = 1.0f / (float)BNO055_EULER_DIV_DEG;
+    static constexpr float ACCEL_SCALE_MSQ = 1.0f / (float)BNO055_ACCEL_DIV_MSQ;
+    static constexpr float LINEAR_ACCEL_SCALE_MSQ = 1.0f / (float)BNO055_LINEAR_ACCEL_DIV_MSQ;
+
     esp_err_t init();
-    bno055_euler_double_t read_double_euler();
-    double read_linear_accel_z();
-    void bno055_euler_queue_push(bno055_euler_double_t euler);
-    QueueHandle_t get_euler_queue_handle() { return bno055_euler_queue; }
-    QueueHandle_t get_linear_accel_z_queue_handle() { return bno055_linear_accel_z_queue; }
-    void bno055_linear_accel_z_queue_push(double linear_accel_z);
+    esp_err_t read_frame(SensorFrame* frame);
+    acquisition_profile_t get_profile() const { return profile; }
+    uint32_t get_sample_rate_hz() const { return profile == PROFILE_VIBRATION ? VIBRATION_SAMPLE_RATE_HZ : SENSOR_SAMPLE_RATE_HZ; }
+    struct ShadowCacheStats {
+        uint32_t hits;
+        uint32_t misses;
+    };
+    static ShadowCacheStats get_shadow_cache_stats() { return { shadow_hits, shadow_misses }; }
+    // 采集任务里调用，按通道的溢出策略处理积压，不会无限期阻塞
+    void bno055_euler_queue_push(int64_t timestamp_us, bno055_euler_t euler);
+    QueueChannel<EulerRecord>& get_euler_channel() { return bno055_euler_channel; }
+    // 传给 DSP 的三轴采样直接写进 DSP 的乒乓缓冲区，按块交接，块内 X/Y/Z 分开连续存放
+    using DspBlockBuffer = PingPongBuffer<dsp_sample_t, DSP_BLOCK_SAMPLES, DSP_AXES>;
+    DspBlockBuffer& get_accel_blocks() { return bno055_accel_blocks; }
+    // 振动模式下送的是原始加速度，融合模式下是线性加速度，两者量纲相同但比例系数分开取
+    float get_accel_scale() const { return profile == PROFILE_VIBRATION ? ACCEL_SCALE_MSQ : LINEAR_ACCEL_SCALE_MSQ; }
+    void bno055_accel_push(s16 x, s16 y, s16 z);
 
 private:
-    QueueHandle_t bno055_euler_queue = xQueueCreate(256, sizeof(bno055_euler_double_t));
-    QueueHandle_t bno055_linear_accel_z_queue = xQueueCreate(256, sizeof(double));
+    acquisition_profile_t profile;
+    QueueChannel<EulerRecord> bno055_euler_channel { EULER_CHANNEL_DEPTH,
+        { EULER_CHANNEL_OVERFLOW, pdMS_TO_TICKS(EULER_CHANNEL_TIMEOUT_MS), EULER_CHANNEL_DECIMATION } };
+    DspBlockBuffer bno055_accel_blocks;
     static SemaphoreHandle_t bno055_mutex;
     static constexpr auto TAG = "bno055";
     struct bno055_t bno055;
     static i2c_master_dev_handle_t i2c_master_dev_handle;
     static i2c_master_bus_handle_t i2c_master_bus_handle;
-    double linear_accel_z;
-    struct bno055_euler_double_t euler;
     static s8 bno055read(u8 dev_addr, u8 reg_addr, u8* reg_data, u8 wr_len);
     static s8 bno055write(u8 dev_addr, u8 reg_addr, u8* reg_data, u8 wr_len);
     static void delay_func(u32 delay_in_msec);
+    // 配置寄存器影子缓存：写直达，配置完成后热路径上的读不再访问总线
+    struct ShadowRegister {
+        u8 addr;
+        u8 value;
+        bool valid;
+    };
+    static ShadowRegister shadow_registers[];
+    static uint32_t shadow_hits;
+    static uint32_t shadow_misses;
+    static ShadowRegister* find_shadow_register(u8 reg_addr);
+    static void invalidate_shadow_registers();
     static void i2c_master_init(i2c_master_bus_handle_t* bus_handle, i2c_master_dev_handle_t* dev_handle);
 };
 #endif // BNO055_DRIVER_HPP
\ No newline at end of file
@@ -1,54 +1,71 @@
 #pragma once
-#include "Bno055Driver.hpp"
+#include "bno055driver.hpp"
 #include "Thread.hpp"
+#include "AcquisitionScheduler.hpp"
 #include "esp_log.h"
 #include "APPConfig.h"
 #include <memory>
 
-class Bno055ReadEulerTask : public Thread {
+// 单一采集任务：由 esp_timer 节拍唤醒，突发读取一帧后分发给各个消费者队列
+class Bno055AcquisitionTask : public Thread {
 public:
-    Bno055ReadEulerTask(std::shared_ptr<Bno055Driver> bno055)
-        : Thread("Bno055ReadEulerTask", 1024 * 3, PRIO_SENSOR, 1)
-        , bno055(bno055) { };
-    ~Bno055ReadEulerTask() { };
+    Bno055AcquisitionTask(std::shared_ptr<Bno055Driver> bno055)
+        : Thread("Bno055AcquisitionTask", 1024 * 3, PRIO_SENSOR, 1)
+        , bno055(bno055)
+        , scheduler(this->bno055->get_sample_rate_hz()) { };
+    ~Bno055AcquisitionTask() { };
+    AcquisitionScheduler& get_scheduler() { return scheduler; }
     void run() override
     {
         bno055->init();
-        TickType_t xLastWakeTime = xTaskGetTickCount();
+        if (scheduler.start(xTaskGetCurrentTaskHandle()) != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to start acquisition scheduler");
+            return;
+        }
+        SensorFrame frame;
         while (true) {
-            bno055_euler_double_t euler = bno055->read_double_euler();
-            bno055->bno055_euler_queue_push(euler);
-            // ESP_LOGI(TAG, "euler: %f, %f, %f", euler.h, euler.r, euler.p);
-            vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(10));
-            // ESP_LOGI(TAG, "Bno055ReadEulerTask stack high water mark: %d", uxTaskGetStackHighWaterMark(NULL));
+            scheduler.wait_next_tick();
+            frame.timestamp_us = scheduler.stamp();
+            if (bno055->read_frame(&frame) != ESP_OK) {
+                continue;
+            }
+            // 队列中只传原始 s16，换算推迟到消费者
+            if (bno055->get_profile() == Bno055Driver::PROFILE_VIBRATION) {
+                bno055->bno055_accel_push(frame.accel.x, frame.accel.y, frame.accel.z); // 振动模式没有融合输出，直接送原始加速度
+            } else {
+                bno055->bno055_euler_queue_push(frame.timestamp_us, frame.euler);
+                bno055->bno055_accel_push(frame.linear_accel.x, frame.linear_accel.y, frame.linear_accel.z);
+            }
+            log_acquisition_stats(frame.timestamp_us);
+            // ESP_LOGI(TAG, "Bno055AcquisitionTask stack high water mark: %d", uxTaskGetStackHighWaterMark(NULL));
         }
     }
 
 private:
-    static constexpr auto TAG = "Bno055ReadEulerTask";
+    static constexpr auto TAG = "Bno055AcquisitionTask";
     std::shared_ptr<Bno055Driver> bno055;
-};
+    AcquisitionScheduler scheduler;
+    int64_t next_stats_us = 0;
+    Bno055Driver::ShadowCacheStats last_shadow = {};
 
-class Bno055ReadLinerAccZTask : public Thread {
-public:
-    Bno055ReadLinerAccZTask(std::shared_ptr<Bno055Driver> bno055)
-        : Thread("Bno055ReadLinerAccZTask", 1024 * 3, PRIO_SENSOR, 1)
-        , bno055(bno055) { };
-    ~Bno055ReadLinerAccZTask() { };
-    void run() override
+    // 打印本周期内的采样间隔抖动与影子缓存命中情况；稳态下只读数据块，配置寄存器的单字节读取应全部命中
+    void log_acquisition_stats(int64_t now_us)
     {
-        bno055->init();
-        TickType_t xLastWakeTime = xTaskGetTickCount();
-        while (true) {
-            double linear_acc_z = bno055->read_linear_accel_z();
-            // ESP_LOGI(TAG, "linear_acc_z: %f", linear_acc_z);
-            bno055->bno055_linear_accel_z_queue_push(linear_acc_z);
-            vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(10));
-            // ESP_LOGI(TAG, "Bno055ReadLinerAccZTask stack high water mark: %d", uxTaskGetStackHighWaterMark(NULL));
+        if (now_us < next_stats_us) {
+            return;
         }
+        next_stats_us = now_us + (int64_t)ACQUISITION_STATS_INTERVAL_MS * 1000;
+        const AcquisitionScheduler::JitterStats jitter = scheduler.get_jitter_stats();
+        scheduler.reset_jitter_stats();
+        ESP_LOGI(TAG, "sample interval (period %lld us): min %lld us, max %lld us, p99 jitter %lu us over %lu samples",
+            (long long)scheduler.get_period_us(), (long long)jitter.min_interval_us, (long long)jitter.max_interval_us,
+            (unsigned long)jitter.p99_jitter_us, (unsigned long)jitter.samples);
+        const Bno055Driver::ShadowCacheStats shadow = Bno055Driver::get_shadow_cache_stats();
+        const uint32_t hits = shadow.hits - last_shadow.hits;
+        const uint32_t misses = shadow.misses - last_shadow.misses;
+        last_shadow = shadow;
+        ESP_LOGI(TAG, "shadow cache: %lu hits, %lu misses (%.1f%% hit), total %lu / %lu",
+            (unsigned long)hits, (unsigned long)misses, hits + misses > 0 ? 100.0f * hits / (hits + misses) : 100.0f,
+            (unsigned long)shadow.hits, (unsigned long)shadow.misses);
     }
-
-private:
-    static constexpr auto TAG = "Bno055ReadLinerAccZTask";
-    std::shared_ptr<Bno055Driver> bno055;
 };
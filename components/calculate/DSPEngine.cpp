@@ -1,76 +1,543 @@
 #include "DSPEngine.hpp"
+#include "DSPMemory.hpp"
 
-void DSPEngine::processAndShow(float* data, int length)
+// 把各轴当前段的周期图并入 Welch 平均，攒够 averages 段时返回 true
+bool DSPEngine::accumulateWelch()
 {
-    // 1. FFT 运算
-    dsps_fft2r_fc32(data, length);
+    welch_segments_++;
+    if (welch_config_.averaging == WELCH_AVG_EXPONENTIAL) {
+        // 指数平均：第一段直接作为初值，之后按 1/averages 的权重更新
+        const float alpha = (welch_segments_ == 1) ? 1.0f : 1.0f / welch_config_.averages;
+        for (int axis = 0; axis < AXES; axis++) {
+            for (int i = 0; i < bins_; i++) {
+                psd_avg_[axis][i] += alpha * (power_[axis][i] - psd_avg_[axis][i]);
+            }
+        }
+        if (welch_segments_ % welch_config_.averages == 0) {
+            return true;
+        }
+        return false;
+    }
+    // N 段线性平均：累加，攒够后输出平均值并清零重新开始
+    for (int axis = 0; axis < AXES; axis++) {
+        dsps_add_f32(psd_acc_[axis], power_[axis], psd_acc_[axis], bins_, 1, 1, 1);
+    }
+    if (welch_segments_ < welch_config_.averages) {
+        return false;
+    }
+    for (int axis = 0; axis < AXES; axis++) {
+        dsps_mulc_f32(psd_acc_[axis], psd_avg_[axis], bins_, 1.0f / welch_segments_, 1, 1);
+        memset(psd_acc_[axis], 0, bins_ * sizeof(float));
+    }
+    welch_segments_ = 0;
+    return true;
+}
+
+// 丢弃未攒够的分段，下一段重新开始平均
+void DSPEngine::resetWelch()
+{
+    welch_segments_ = 0;
+    for (int axis = 0; axis < AXES; axis++) {
+        memset(psd_acc_[axis], 0, bins_ * sizeof(float));
+    }
+}
+
+// 连续模式每个 hop 都做 FFT；触发模式下监测频率超过阈值才开始，输出一次 Welch 平均后重新等待触发
+// 没有任何监测频率带阈值时触发模式永远不会开始 FFT，退回连续模式
+bool DSPEngine::shouldRunFFT()
+{
+    if (mode_.load() != MODE_TONE_TRIGGERED) {
+        return true;
+    }
+    if (!tone_bank_.hasTriggers()) {
+        ESP_LOGW(TAG, "tone-triggered mode without any tone threshold (%d tones), fall back to continuous", tone_bank_.getToneCount());
+        mode_.store(MODE_CONTINUOUS);
+        return true;
+    }
+    if (!fft_triggered_) {
+        int tone = tone_bank_.findTriggered();
+        if (tone < 0) {
+            return false;
+        }
+        ESP_LOGI(TAG, "tone %.2fHz on axis %d reached %.3f, start FFT",
+            tone_bank_.getTone(tone).freq_hz, tone_bank_.getTone(tone).axis, tone_bank_.getAmplitude(tone));
+        fft_triggered_ = true;
+        resetWelch(); // 上次触发残留的分段不能混进这次的平均
+    }
+    return true;
+}
+
+// 频谱平均完成后按轴提取特征，再加一条三轴矢量合成记录，并与基线比较给出异常分数
+// 基线学完后只上报超过阈值的帧（ANOMALY_REPORT_BY_EXCEPTION），放入特征队列供上行任务取走；队列满时丢弃最新记录
+void DSPEngine::publishFeatures()
+{
+    // 矢量合成谱 = 各轴谱之和 (Parseval)，平均是线性运算，直接对平均后的谱求和即可，不必多做一次 FFT
+    float* vector_psd = psd_avg_[AXES];
+    memcpy(vector_psd, psd_avg_[0], bins_ * sizeof(float));
+    for (int axis = 1; axis < AXES; axis++) {
+        dsps_add_f32(vector_psd, psd_avg_[axis], vector_psd, bins_, 1, 1, 1);
+    }
+
+    if (baseline_reset_requested_.exchange(false)) {
+        baseline_.reset();
+        ESP_LOGI(TAG, "baseline reset, learning again");
+    }
+    const bool ready = baseline_.isReady();
+    float scores[CHANNELS] = {};
+    float peak_z[CHANNELS] = {};
+    bool anomalous = false;
+    if (ready) {
+        for (int channel = 0; channel < CHANNELS; channel++) {
+            scores[channel] = baseline_.score(channel, psd_avg_[channel], &peak_z[channel]);
+            anomalous = anomalous || scores[channel] >= ANOMALY_SCORE_THRESHOLD || peak_z[channel] >= ANOMALY_PEAK_Z_THRESHOLD;
+        }
+    }
+    updateBaseline(anomalous);
+    if (anomalous && capture_.getTriggerConfig().on_spectral_anomaly) {
+        int worst = 0;
+        for (int axis = 1; axis < AXES; axis++) {
+            worst = (scores[axis] > scores[worst]) ? axis : worst;
+        }
+        capture_.trigger(WaveformCapture::TRIGGER_SPECTRAL, worst);
+    }
+    if (ready && ANOMALY_REPORT_BY_EXCEPTION && !anomalous) {
+        return;
+    }
+
+    const int64_t timestamp_us = esp_timer_get_time();
+    for (int channel = 0; channel < CHANNELS; channel++) {
+        SpectralFeatures features;
+        feature_extractor_.extract(psd_avg_[channel], bins_, sample_rate_hz_, timeDomainSamples(channel), fft_size_, &features);
+        features.timestamp_us = timestamp_us;
+        features.axis = (channel < AXES) ? channel : SPECTRAL_AXIS_VECTOR;
+        features.anomaly_score = scores[channel];
+        features.anomaly_peak_z = peak_z[channel];
+#if !DSP_FFT_FIXED_POINT
+        memcpy(features.envelope_peaks, envelope_.getPeaks(channel), sizeof(features.envelope_peaks));
+#endif
+        ESP_LOGD(TAG, "axis %d dominant %.2fHz, rms %.3f, crest %.2f, kurtosis %.2f, score %.2f",
+            features.axis, features.dominant_freq_hz, features.rms, features.crest_factor, features.kurtosis, features.anomaly_score);
+        features_channel_.push(features);
+    }
+}
+
+// 正常的帧并入基线，异常的帧不学习，避免故障被当成新的正常状态；定期写入 LittleFS
+void DSPEngine::updateBaseline(bool anomalous)
+{
+    if (anomalous) {
+        return;
+    }
+    const bool was_ready = baseline_.isReady();
+    for (int channel = 0; channel < CHANNELS; channel++) {
+        baseline_.update(channel, psd_avg_[channel]);
+    }
+    baseline_.commitFrame();
+    if (++baseline_unsaved_ >= BASELINE_SAVE_FRAMES || (!was_ready && baseline_.isReady())) {
+        baseline_unsaved_ = 0;
+        esp_err_t ret = baseline_.save(sample_rate_hz_);
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "failed to save baseline: %s", esp_err_to_name(ret));
+        }
+    }
+}
+
+// 特征提取用的时域样本（物理量）；矢量通道为三轴矢量模
+// 浮点模式下轴通道直接用历史缓冲区，矢量模写到 samples_；定点模式下都换算到 samples_
+const float* DSPEngine::timeDomainSamples(int channel)
+{
+#if DSP_FFT_FIXED_POINT
+    float* samples = samples_;
+    if (channel < AXES) {
+        for (int i = 0; i < fft_size_; i++) {
+            samples[i] = history_[channel][i] * sample_scale_;
+        }
+        return samples;
+    }
+    const float scale = sample_scale_;
+#else
+    if (channel < AXES) {
+        return history_[channel];
+    }
+    float* samples = samples_;
+    const float scale = 1.0f;
+#endif
+    for (int i = 0; i < fft_size_; i++) {
+        float sum = 0;
+        for (int axis = 0; axis < AXES; axis++) {
+            const float v = history_[axis][i];
+            sum += v * v;
+        }
+        samples[i] = sqrtf(sum) * scale;
+    }
+    return samples;
+}
+
+void DSPEngine::setPreFilter(float highpass_cutoff_hz, int decimation)
+{
+#if DSP_FFT_FIXED_POINT
+    ESP_LOGW(TAG, "pre-filter is not available in fixed-point mode");
+#else
+    highpass_cutoff_hz_ = highpass_cutoff_hz;
+    decimation_ = decimation;
+#endif
+}
+
+void DSPEngine::setEnvelope(float band_low_hz, float band_high_hz, int decimation)
+{
+#if DSP_FFT_FIXED_POINT
+    ESP_LOGW(TAG, "envelope analysis is not available in fixed-point mode");
+#else
+    envelope_band_hz_[0] = band_low_hz;
+    envelope_band_hz_[1] = band_high_hz;
+    envelope_decimation_ = decimation;
+#endif
+}
+
+void DSPEngine::setTones(const ToneSpec* tones, int count)
+{
+    pending_tone_count_ = count > TONE_BANK_MAX_TONES ? TONE_BANK_MAX_TONES : count;
+    memcpy(pending_tones_, tones, pending_tone_count_ * sizeof(ToneSpec));
+}
+
+void DSPEngine::setFeatureBands(const FeatureBand* bands, int count)
+{
+    feature_extractor_.setBands(bands, count);
+}
 
-    // 2. 位反转 (必要步骤，让频率顺序正常)
-    dsps_bit_rev_fc32(data, length);
+void DSPEngine::setWelchConfig(const WelchConfig& config)
+{
+    WelchConfig checked = config;
+    // 重叠率在 [0, 1) 内，步进在 configureFFTSize 中按点数换算
+    if (!(checked.overlap >= 0.0f && checked.overlap < 1.0f)) {
+        ESP_LOGW(TAG, "invalid Welch overlap %.2f, keep %.2f", checked.overlap, welch_config_.overlap);
+        checked.overlap = welch_config_.overlap;
+    }
+    if (checked.averages < 1) {
+        checked.averages = 1;
+    }
+    welch_config_ = checked;
+}
 
-    // 3. 计算功率谱 (dB)并存回 data 数组的前半部分
-    // 即使 data 是复数数组，我们也可以把结果存到偶数位(data[i*2])来实现原地存储
-    for (int i = 0; i < length / 2; i++) {
-        float real = data[i * 2 + 0];
-        float imag = data[i * 2 + 1];
+// 每次都从配置的重叠率换算，不在上一个点数的步进上累积缩放：取最接近的采集块整数倍，至少一块
+// 步进与 n 一样按抽取后的样本计，run() 每处理一块累加的也是抽取后的样本数
+int DSPEngine::welchHop(int n) const
+{
+#if DSP_FFT_FIXED_POINT
+    const int block = DSP_BLOCK_SAMPLES;
+#else
+    const int block = DSP_BLOCK_SAMPLES / pre_filter_.getDecimation();
+#endif
+    const int blocks = (int)lrintf(n * (1.0f - welch_config_.overlap) / block);
+    return blocks < 1 ? block : blocks * block;
+}
 
-        // 功率 = 实部平方 + 虚部平方
-        // 除以 N 是归一化
-        float power = (real * real + imag * imag) / length;
+// 工作缓冲区按最大点数一次分配，之后切换点数不再分配；启用 PSRAM 时放在 PSRAM
+esp_err_t DSPEngine::allocateBuffers()
+{
+    samples_ = dspAlloc<float>(MAX_N);
+    bool ok = samples_ != nullptr;
+    for (int axis = 0; axis < AXES; axis++) {
+        history_[axis] = dspAlloc<dsp_sample_t>(MAX_N);
+#if DSP_FFT_FIXED_POINT
+        y_cf_[axis] = dspAlloc<int16_t>(MAX_N);
+        ok = ok && y_cf_[axis] != nullptr;
+#endif
+        power_[axis] = dspAlloc<float>(MAX_BINS);
+        psd_acc_[axis] = dspAlloc<float>(MAX_BINS);
+        ok = ok && history_[axis] != nullptr && power_[axis] != nullptr && psd_acc_[axis] != nullptr;
+    }
+    for (int channel = 0; channel < CHANNELS; channel++) {
+        psd_avg_[channel] = dspAlloc<float>(MAX_BINS);
+        ok = ok && psd_avg_[channel] != nullptr;
+    }
+    return ok ? ESP_OK : ESP_ERR_NO_MEM;
+}
 
-        // 防止 log(0)
-        if (power < 1e-10)
-            power = 1e-10;
+DSPEngine::~DSPEngine()
+{
+    heap_caps_free(samples_);
+    for (int axis = 0; axis < AXES; axis++) {
+        heap_caps_free(history_[axis]);
+#if DSP_FFT_FIXED_POINT
+        heap_caps_free(y_cf_[axis]);
+#endif
+        heap_caps_free(power_[axis]);
+        heap_caps_free(psd_acc_[axis]);
+    }
+    for (int channel = 0; channel < CHANNELS; channel++) {
+        heap_caps_free(psd_avg_[channel]);
+    }
+}
 
-        data[i] = 10 * log10f(power);   // 空间复用
+esp_err_t DSPEngine::requestFFTSize(int n)
+{
+    if (!FFTPlanCache::isValidSize(n)) {
+        ESP_LOGW(TAG, "invalid FFT size %d, must be a power of 2 in %d ~ %d", n, FFTPlanCache::MIN_SIZE, FFTPlanCache::MAX_SIZE);
+        return ESP_ERR_INVALID_ARG;
     }
+    requested_fft_size_.store(n);
+    return ESP_OK;
+}
 
-    // 4. 显示功率谱
-    if (length >= 512) {
-        ESP_LOGI(TAG, "FFT Result (0Hz - %dHz):", 100 / 2); // 假设100Hz采样
-        dsps_view(data, length / 2, 128, 20, -60, 40, '|');
+// 按点数 n 配置频谱分析：窗函数、FFT、Welch 步进、频率监测组、包络分析与基线都跟随点数
+// 启动时和运行中切换点数时调用，历史与平均都从头开始
+esp_err_t DSPEngine::configureFFTSize(int n)
+{
+    fft_size_ = n;
+    bins_ = n / 2;
+    esp_err_t ret = initWindowAndFFT();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    hop_ = welchHop(n);
+    const float overlap = (float)(n - hop_) / n;
+    if (fabsf(overlap - welch_config_.overlap) > 0.005f) {
+        ESP_LOGW(TAG, "overlap %.0f%% not reachable in whole blocks at %d points, using %.0f%% (hop %d)",
+            100.0f * welch_config_.overlap, n, 100.0f * overlap, hop_);
     }
+    for (int axis = 0; axis < AXES; axis++) {
+        memset(history_[axis], 0, n * sizeof(dsp_sample_t));
+    }
+    resetWelch();
+    fft_triggered_ = false;
+    tone_bank_.configure(pending_tones_, pending_tone_count_, sample_rate_hz_, n); // 与 FFT 同样的窗长，分辨率一致
+#if !DSP_FFT_FIXED_POINT
+    if (envelope_.configure(bno055->get_sample_rate_hz(), envelope_band_hz_[0], envelope_band_hz_[1], envelope_decimation_, n) == ESP_OK) {
+        ESP_LOGI(TAG, "envelope band %.0f ~ %.0fHz, envelope rate %" PRIu32 "Hz",
+            envelope_band_hz_[0], envelope_band_hz_[1], envelope_.getOutputRateHz());
+    } else {
+        ESP_LOGI(TAG, "envelope analysis disabled (band %.0f ~ %.0fHz at %" PRIu32 "Hz)",
+            envelope_band_hz_[0], envelope_band_hz_[1], bno055->get_sample_rate_hz());
+    }
+#endif
+    ret = baseline_.setBins(bins_);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    baseline_unsaved_ = 0;
+    if (baseline_.load(sample_rate_hz_) == ESP_OK) {
+        ESP_LOGI(TAG, "baseline loaded, %" PRIu32 " frames learned", baseline_.getCount());
+    } else {
+        ESP_LOGI(TAG, "no usable baseline, learning from scratch");
+    }
+    ESP_LOGI(TAG, "input rate %" PRIu32 "Hz, spectrum rate %" PRIu32 "Hz, %d points, resolution %.3fHz, hop %d (overlap %.0f%%)",
+        bno055->get_sample_rate_hz(), sample_rate_hz_, n, (float)sample_rate_hz_ / n, hop_, 100.0f * overlap);
+    return ESP_OK;
+}
+
+// 生成当前点数的窗函数与拆分旋转因子，并初始化对应精度的共享 FFT 表；需在采样率确定之后调用
+esp_err_t DSPEngine::initWindowAndFFT()
+{
+#if DSP_FFT_FIXED_POINT
+    return spectrum_.init(sample_rate_hz_, fft_size_, sample_scale_, samples_); // 浮点窗只在初始化时用一次，借用 samples_ 生成
+#else
+    PipelineContext ctx = { sample_rate_hz_, fft_size_, 0 };
+    return pipeline_.init(ctx);
+#endif
 }
 
 void DSPEngine::run()
 {
     // 1. 初始化
-    esp_err_t ret = dsps_fft2r_init_fc32(NULL, N_SAMPLES);
+    sample_rate_hz_ = bno055->get_sample_rate_hz();
+#if DSP_FFT_FIXED_POINT
+    sample_scale_ = bno055->get_accel_scale();
+#else
+    if (pre_filter_.configure(sample_rate_hz_, highpass_cutoff_hz_, decimation_) != ESP_OK) {
+        ESP_LOGW(TAG, "invalid pre-filter config (cutoff %.2fHz, decimation %d), bypass", highpass_cutoff_hz_, decimation_);
+        pre_filter_.configure(sample_rate_hz_, 0, 1);
+    }
+    sample_rate_hz_ = pre_filter_.getOutputRateHz(); // 之后的频率轴、频带与监测频率都以抽取后的采样率为准
+#endif
+    esp_err_t ret = allocateBuffers();
+    if (ret == ESP_OK) {
+        ret = configureFFTSize(fft_size_);
+    }
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "FFT Init Failed: %d", ret);
         return;
     }
-    dsps_wind_hann_f32(wind_, N); // 生成窗函数
     fft_initialized_ = true;
-    double linear_accel_z = 0;
+    if (feature_extractor_.getBandCount() == 0) {
+        feature_extractor_.setDefaultBands(sample_rate_hz_);
+    }
+    if (capture_.init(bno055->get_sample_rate_hz(), bno055->get_accel_scale()) != ESP_OK) {
+        ESP_LOGW(TAG, "waveform capture disabled");
+    }
+    auto& blocks = bno055->get_accel_blocks();
+    blocks.set_consumer(xTaskGetCurrentTaskHandle()); // 采集任务写满一块才唤醒一次
+    int history_pos = 0; // 下一块写入 history_ 的位置，也是最旧样本的位置
+    int history_filled = 0;
+    int since_last_segment = 0;
 
     while (true) {
         // 这样如果没有数据，任务会挂起，不占用 CPU，比非阻塞好
-        if (xQueueReceive(bno055->get_linear_accel_z_queue_handle(), &linear_accel_z, portMAX_DELAY)) {
-
-            // 3. 填入乒乓缓存
-            input_buffers_[write_buffer_idx_][write_sample_idx_] = static_cast<float>(linear_accel_z);
-            write_sample_idx_++;
-
-            if (write_sample_idx_ >= N) {
-                // A. 获取刚刚填满的 buffer 指针
-                auto process_ptr = input_buffers_[write_buffer_idx_];
-
-                // B. 切换到另一个 buffer 继续接收 (让下一轮循环使用)
-                write_buffer_idx_ = !write_buffer_idx_; // 0 -> 1, 1 -> 0
-                write_sample_idx_ = 0;
-
-                // C. 准备 FFT 输入数据 (加窗 + 构造复数)
-                for (int i = 0; i < N; i++) {
-                    // 实部 = 原始数据 * 窗函数
-                    y_cf_[i * 2 + 0] = process_ptr[i] * wind_[i];
-                    // 虚部 = 0
-                    y_cf_[i * 2 + 1] = 0;
-                }
-
-                // D. 执行 FFT 计算
-                processAndShow(y_cf_, N);
+        const dsp_sample_t* block = blocks.wait_block(portMAX_DELAY);
+        if (block == nullptr) {
+            continue;
+        }
+        // 切换 FFT 点数：在两块之间进行，先保存当前点数下学到的基线
+        const int requested_size = requested_fft_size_.exchange(0);
+        if (requested_size != 0 && requested_size != fft_size_) {
+            const int old_size = fft_size_;
+            if (baseline_.getCount() > 0) {
+                baseline_.save(sample_rate_hz_);
+            }
+            if (configureFFTSize(requested_size) != ESP_OK) {
+                ESP_LOGE(TAG, "failed to switch to %d points, back to %d", requested_size, old_size);
+                configureFFTSize(old_size);
             }
+            history_pos = 0;
+            history_filled = 0;
+            since_last_segment = 0;
+        }
+        // 波形捕获取原始样本，冲击的上升沿不经过高通与抽取
+        capture_.feed(block, DSP_BLOCK_SAMPLES, DSP_BLOCK_SAMPLES);
+
+        // A. 预处理：高通去除重力与直流，抗混叠低通后抽取；定点模式下不做预处理
+        uint32_t cycles = esp_cpu_get_cycle_count();
+#if !DSP_FFT_FIXED_POINT
+        // 包络分析同样取原始采样率的样本，共振带通常远高于主频谱抽取后的带宽
+        if (envelope_.isEnabled() && envelope_.process(block, DSP_BLOCK_SAMPLES, DSP_BLOCK_SAMPLES)) {
+            analyzeEnvelope();
         }
+        cycles = stampStage(STAGE_ENVELOPE, cycles);
+#endif
+        const dsp_sample_t* samples[AXES];
+        int count = DSP_BLOCK_SAMPLES;
+        for (int axis = 0; axis < AXES; axis++) {
+#if DSP_FFT_FIXED_POINT
+            samples[axis] = block + axis * DSP_BLOCK_SAMPLES;
+#else
+            count = DSP_BLOCK_SAMPLES;
+            samples[axis] = pre_filter_.process(axis, block + axis * DSP_BLOCK_SAMPLES, &count);
+#endif
+        }
+        cycles = stampStage(STAGE_FILTER, cycles);
+
+        // B. 频率监测组逐点递推，被覆盖之前的历史样本正好是窗口另一端要移出的样本
+#if DSP_FFT_FIXED_POINT
+        const float tone_scale = sample_scale_;
+#else
+        const float tone_scale = 1.0f;
+#endif
+        for (int axis = 0; axis < AXES; axis++) {
+            tone_bank_.update(axis, samples[axis], &history_[axis][history_pos], count, tone_scale);
+        }
+        stampStage(STAGE_TONES, cycles);
+
+        // C. 新样本各轴写进各自的环形历史缓冲区，只拷贝这一块，不搬动已有历史
+        for (int axis = 0; axis < AXES; axis++) {
+            memcpy(&history_[axis][history_pos], samples[axis], count * sizeof(dsp_sample_t));
+        }
+        blocks.release_block(); // 不做预处理时 samples 直接指向块内数据，拷贝完才能归还
+        history_pos = (history_pos + count) % fft_size_;
+        if (history_filled < fft_size_) {
+            history_filled += count;
+        }
+        since_last_segment += count;
+        if (history_filled < fft_size_ || since_last_segment < hop_) {
+            continue;
+        }
+        since_last_segment = 0;
+        if (!shouldRunFFT()) {
+            continue;
+        }
+        int64_t start_us = esp_timer_get_time();
+        uint32_t samples_at_start = blocks.get_samples_written();
+
+        cycles = esp_cpu_get_cycle_count();
+#if DSP_FFT_FIXED_POINT
+        // D. 各轴加窗并直接按 N/2 点复数排列：相邻两个实数样本就是一个复数的实部和虚部
+        // 历史缓冲区从 history_pos 开始是最旧的样本，分两段与窗函数相乘即可，无需先摆正
+        for (int axis = 0; axis < AXES; axis++) {
+            spectrum_.window(history_[axis], history_pos, y_cf_[axis]);
+        }
+        cycles = stampStage(STAGE_WINDOW, cycles);
+
+        // E. 逐轴执行 FFT 并求周期图
+        for (int axis = 0; axis < AXES; axis++) {
+            spectrum_.transform(y_cf_[axis]);
+        }
+        cycles = stampStage(STAGE_FFT, cycles);
+        for (int axis = 0; axis < AXES; axis++) {
+            spectrum_.power(y_cf_[axis], power_[axis]);
+        }
+        cycles = stampStage(STAGE_POWER, cycles);
+#else
+        // D. 各轴依次走处理链：加窗 -> 实数 FFT -> 周期图，每级结束时把周期数记到对应阶段
+        for (int axis = 0; axis < AXES; axis++) {
+            const float* power = pipeline_.run(RingInput { history_[axis], history_pos }, [&](size_t stage) {
+                cycles = stampStage(static_cast<stage_t>(STAGE_WINDOW + stage), cycles);
+            });
+            memcpy(power_[axis], power, bins_ * sizeof(float));
+        }
+#endif
+
+        // F. 并入 Welch 平均
+        bool averaged = accumulateWelch();
+        cycles = stampStage(STAGE_WELCH, cycles);
+        if (averaged) {
+            publishFeatures();
+            stampStage(STAGE_FEATURES, cycles);
+            fft_triggered_ = false;
+        }
+
+        updateOverlapStats(start_us, esp_timer_get_time(), blocks.get_samples_written() - samples_at_start);
+        if (stats_frames_ == 0) {
+            ESP_LOGI(TAG, "overlap ratio: %.2f, dropped blocks: %" PRIu32, overlap_ratio_, blocks.get_overruns());
+            logStageCycles();
+        }
+    }
+}
+
+#if !DSP_FFT_FIXED_POINT
+// 各轴包络历史走与主频谱相同的处理链，周期图按包络采样率重新归一化后交回包络分析器平均
+// 处理链的输出缓冲区在这里用完即交回，不影响之后的主频谱
+void DSPEngine::analyzeEnvelope()
+{
+    const float psd_scale = (float)sample_rate_hz_ / envelope_.getOutputRateHz();
+    for (int axis = 0; axis < AXES; axis++) {
+        envelope_.accumulate(axis, pipeline_.run(envelope_.getHistory(axis)), psd_scale);
+    }
+    envelope_.finishSegment();
+}
+#endif
+
+// 累计一个阶段耗费的 CPU 周期，返回当前周期数作为下一阶段的起点
+uint32_t DSPEngine::stampStage(stage_t stage, uint32_t start_cycles)
+{
+    uint32_t now = esp_cpu_get_cycle_count();
+    stage_cycles_[stage] += now - start_cycles;
+    return now;
+}
+
+// 打印各阶段平均每帧的 CPU 周期数（特征提取只在平均完成的帧上发生，同样按帧数平均）
+void DSPEngine::logStageCycles()
+{
+    ESP_LOGI(TAG, "cycles/frame x%d axes: filter %" PRIu32 ", tones %" PRIu32 ", envelope %" PRIu32 ", window %" PRIu32 ", fft %" PRIu32 ", power %" PRIu32 ", welch %" PRIu32 ", features %" PRIu32,
+        AXES,
+        stage_cycles_[STAGE_FILTER] / STATS_REPORT_FRAMES,
+        stage_cycles_[STAGE_TONES] / STATS_REPORT_FRAMES,
+        stage_cycles_[STAGE_ENVELOPE] / STATS_REPORT_FRAMES,
+        stage_cycles_[STAGE_WINDOW] / STATS_REPORT_FRAMES,
+        stage_cycles_[STAGE_FFT] / STATS_REPORT_FRAMES,
+        stage_cycles_[STAGE_POWER] / STATS_REPORT_FRAMES,
+        stage_cycles_[STAGE_WELCH] / STATS_REPORT_FRAMES,
+        stage_cycles_[STAGE_FEATURES] / STATS_REPORT_FRAMES);
+    memset(stage_cycles_, 0, sizeof(stage_cycles_));
+}
+
+void DSPEngine::updateOverlapStats(int64_t start_us, int64_t end_us, uint32_t samples_written)
+{
+    const int64_t window_us = end_us - start_us;
+    const int64_t acquired_us = (int64_t)samples_written * 1000000 / bno055->get_sample_rate_hz();
+    compute_us_ += window_us;
+    overlap_us_ += acquired_us < window_us ? acquired_us : window_us;
+    if (++stats_frames_ >= STATS_REPORT_FRAMES) {
+        overlap_ratio_ = compute_us_ > 0 ? (float)overlap_us_ / compute_us_ : 0;
+        compute_us_ = 0;
+        overlap_us_ = 0;
+        stats_frames_ = 0;
     }
 }
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "EnvelopeAnalyzer.hpp"
+#include "DSPMemory.hpp"
+#include <math.h>
+#include <string.h>
+
+EnvelopeAnalyzer::~EnvelopeAnalyzer()
+{
+    for (int axis = 0; axis < DSP_AXES; axis++) {
+        heap_caps_free(history_[axis]);
+    }
+    for (int channel = 0; channel < CHANNELS; channel++) {
+        heap_caps_free(psd_avg_[channel]);
+    }
+}
+
+esp_err_t EnvelopeAnalyzer::configure(uint32_t input_rate_hz, float band_low_hz, float band_high_hz, int decimation, int fft_size)
+{
+    enabled_ = false;
+    if (fft_size > MAX_N) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (decimation < 1 || decimation > ENVELOPE_MAX_DECIMATION || (decimation & (decimation - 1)) != 0
+        || DSP_BLOCK_SAMPLES % decimation != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (band_low_hz <= 0 || band_high_hz <= band_low_hz || band_high_hz >= input_rate_hz / 2.0f) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int axis = 0; axis < DSP_AXES; axis++) {
+        if (history_[axis] == nullptr && (history_[axis] = dspAlloc<float>(MAX_N)) == nullptr) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    for (int channel = 0; channel < CHANNELS; channel++) {
+        if (psd_avg_[channel] == nullptr && (psd_avg_[channel] = dspAlloc<float>(MAX_N / 2)) == nullptr) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    input_rate_hz_ = input_rate_hz;
+    decimation_ = decimation;
+    n_ = fft_size;
+
+    dsps_biquad_gen_hpf_f32(bandpass_coeffs_[0], band_low_hz / input_rate_hz, 0.707f);
+    dsps_biquad_gen_lpf_f32(bandpass_coeffs_[1], band_high_hz / input_rate_hz, 0.707f);
+    // 截止频率取输出奈奎斯特频率的 80%；四阶巴特沃斯两节的 Q 分别为 0.541 与 1.307
+    const float cutoff = 0.8f * 0.5f / decimation_;
+    dsps_biquad_gen_lpf_f32(lowpass_coeffs_[0], cutoff, 0.541f);
+    dsps_biquad_gen_lpf_f32(lowpass_coeffs_[1], cutoff, 1.307f);
+    memset(bandpass_state_, 0, sizeof(bandpass_state_));
+    memset(lowpass_state_, 0, sizeof(lowpass_state_));
+    memset(mean_, 0, sizeof(mean_));
+    for (int axis = 0; axis < DSP_AXES; axis++) {
+        memset(history_[axis], 0, n_ * sizeof(float));
+    }
+    for (int channel = 0; channel < CHANNELS; channel++) {
+        memset(psd_avg_[channel], 0, n_ / 2 * sizeof(float));
+    }
+    memset(peaks_, 0, sizeof(peaks_));
+    history_pos_ = 0;
+    history_filled_ = 0;
+    since_last_segment_ = 0;
+    segments_ = 0;
+    enabled_ = true;
+    return ESP_OK;
+}
+
+bool EnvelopeAnalyzer::process(const float* block, int count, int stride)
+{
+    const int out_count = count / decimation_;
+    for (int axis = 0; axis < DSP_AXES; axis++) {
+        // 各级滤波都在 work_ 上原地进行
+        dsps_biquad_f32(block + axis * stride, work_, count, bandpass_coeffs_[0], bandpass_state_[axis][0]);
+        dsps_biquad_f32(work_, work_, count, bandpass_coeffs_[1], bandpass_state_[axis][1]);
+        for (int i = 0; i < count; i++) {
+            work_[i] = fabsf(work_[i]);
+        }
+        dsps_biquad_f32(work_, work_, count, lowpass_coeffs_[0], lowpass_state_[axis][0]);
+        dsps_biquad_f32(work_, work_, count, lowpass_coeffs_[1], lowpass_state_[axis][1]);
+
+        // 抽取并去掉包络的直流分量，否则包络谱的低频点会被整流后的均值淹没
+        int pos = history_pos_;
+        for (int i = decimation_ - 1; i < count; i += decimation_) {
+            mean_[axis] += MEAN_ALPHA * (work_[i] - mean_[axis]);
+            history_[axis][pos] = work_[i] - mean_[axis];
+            pos = (pos + 1) % n_;
+        }
+    }
+    history_pos_ = (history_pos_ + out_count) % n_;
+    if (history_filled_ < n_) {
+        history_filled_ += out_count;
+    }
+    since_last_segment_ += out_count;
+    if (history_filled_ < n_ || since_last_segment_ < n_ / 2) {
+        return false;
+    }
+    since_last_segment_ = 0;
+    return true;
+}
+
+void EnvelopeAnalyzer::accumulate(int axis, const float* power, float psd_scale)
+{
+    // 指数平均：第一段直接作为初值，之后按 1/ENVELOPE_AVERAGES 的权重更新
+    const float alpha = (segments_ == 0) ? 1.0f : 1.0f / ENVELOPE_AVERAGES;
+    for (int i = 0; i < n_ / 2; i++) {
+        psd_avg_[axis][i] += alpha * (power[i] * psd_scale - psd_avg_[axis][i]);
+    }
+}
+
+void EnvelopeAnalyzer::finishSegment()
+{
+    segments_++;
+    float* vector_psd = psd_avg_[DSP_AXES];
+    memcpy(vector_psd, psd_avg_[0], n_ / 2 * sizeof(float));
+    for (int axis = 1; axis < DSP_AXES; axis++) {
+        dsps_add_f32(vector_psd, psd_avg_[axis], vector_psd, n_ / 2, 1, 1, 1);
+    }
+    const float df = (float)getOutputRateHz() / n_;
+    for (int channel = 0; channel < CHANNELS; channel++) {
+        SpectralFeatureExtractor::findPeaks(psd_avg_[channel], n_ / 2, df, peaks_[channel]);
+    }
+}
@@ -0,0 +1,63 @@
+#include "FFTPlanCache.hpp"
+#include "DSPMemory.hpp"
+#include "esp_dsp.h"
+#include "esp_log.h"
+#include <math.h>
+
+float* FFTPlanCache::fc32_table_ = nullptr;
+int16_t* FFTPlanCache::sc16_table_ = nullptr;
+float* FFTPlanCache::split_table_ = nullptr;
+
+// 复数 FFT 为 N/2 点，表长按最大复数点数给出
+esp_err_t FFTPlanCache::initFloat()
+{
+    if (fc32_table_ != nullptr) {
+        return ESP_OK;
+    }
+    fc32_table_ = dspAlloc<float>(MAX_SIZE / 2, DSP_HOT_MALLOC_CAPS);
+    if (fc32_table_ == nullptr) {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t ret = dsps_fft2r_init_fc32(fc32_table_, MAX_SIZE / 2);
+    if (ret != ESP_OK) {
+        heap_caps_free(fc32_table_);
+        fc32_table_ = nullptr;
+        return ret;
+    }
+    ESP_LOGI(TAG, "fc32 table for up to %d points", MAX_SIZE);
+    return ESP_OK;
+}
+
+esp_err_t FFTPlanCache::initFixed()
+{
+    if (sc16_table_ != nullptr) {
+        return ESP_OK;
+    }
+    sc16_table_ = dspAlloc<int16_t>(MAX_SIZE / 2, DSP_HOT_MALLOC_CAPS);
+    if (sc16_table_ == nullptr) {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t ret = dsps_fft2r_init_sc16(sc16_table_, MAX_SIZE / 2);
+    if (ret != ESP_OK) {
+        heap_caps_free(sc16_table_);
+        sc16_table_ = nullptr;
+        return ret;
+    }
+    ESP_LOGI(TAG, "sc16 table for up to %d points", MAX_SIZE);
+    return ESP_OK;
+}
+
+const float* FFTPlanCache::splitTwiddles()
+{
+    if (split_table_ == nullptr) {
+        split_table_ = dspAlloc<float>(MAX_SIZE / 2 + 2, DSP_HOT_MALLOC_CAPS);
+        if (split_table_ == nullptr) {
+            return nullptr;
+        }
+        for (int k = 0; k <= MAX_SIZE / 4; k++) { // 旋转因子 W^k = e^(-j*2*pi*k/max)
+            split_table_[k * 2 + 0] = cosf(2 * M_PI * k / MAX_SIZE);
+            split_table_[k * 2 + 1] = -sinf(2 * M_PI * k / MAX_SIZE);
+        }
+    }
+    return split_table_;
+}
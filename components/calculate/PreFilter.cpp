@@ -0,0 +1,68 @@
+#include "PreFilter.hpp"
+#include <math.h>
+#include <string.h>
+
+esp_err_t PreFilter::configure(uint32_t input_rate_hz, float cutoff_hz, int decimation)
+{
+    if (decimation < 1 || decimation > PRE_FILTER_MAX_DECIMATION || (decimation & (decimation - 1)) != 0
+        || DSP_BLOCK_SAMPLES % decimation != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (cutoff_hz >= input_rate_hz / 2.0f) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    input_rate_hz_ = input_rate_hz;
+    decimation_ = decimation;
+
+    highpass_enabled_ = cutoff_hz > 0;
+    if (highpass_enabled_) {
+        // Q = 0.707，巴特沃斯响应
+        dsps_biquad_gen_hpf_f32(biquad_coeffs_, cutoff_hz / input_rate_hz, 0.707f);
+    }
+    memset(biquad_state_, 0, sizeof(biquad_state_));
+
+    taps_ = 0;
+    if (decimation_ > 1) {
+        taps_ = PRE_FILTER_TAPS_PER_RATIO * decimation_;
+        // 截止频率取输出奈奎斯特频率的 80%，给过渡带留出余量
+        designLowpass(taps_, 0.8f * 0.5f / decimation_);
+        memset(fir_delay_, 0, sizeof(fir_delay_));
+        for (int axis = 0; axis < DSP_AXES; axis++) {
+            dsps_fird_init_f32(&fir_[axis], fir_coeffs_, fir_delay_[axis], taps_, decimation_);
+        }
+    }
+    return ESP_OK;
+}
+
+// 加 Blackman 窗的 sinc 低通，直流增益归一化为 1
+void PreFilter::designLowpass(int taps, float cutoff)
+{
+    const float center = (taps - 1) / 2.0f;
+    float sum = 0;
+    for (int i = 0; i < taps; i++) {
+        const float t = i - center;
+        const float sinc = (t == 0) ? 2 * cutoff : sinf(2 * M_PI * cutoff * t) / (M_PI * t);
+        const float window = 0.42f - 0.5f * cosf(2 * M_PI * i / (taps - 1)) + 0.08f * cosf(4 * M_PI * i / (taps - 1));
+        fir_coeffs_[i] = sinc * window;
+        sum += fir_coeffs_[i];
+    }
+    for (int i = 0; i < taps; i++) {
+        fir_coeffs_[i] /= sum;
+    }
+}
+
+const float* PreFilter::process(int axis, const float* input, int* count)
+{
+    const float* data = input;
+    if (highpass_enabled_) {
+        float* target = (decimation_ > 1) ? highpassed_ : output_[axis];
+        dsps_biquad_f32(data, target, *count, biquad_coeffs_, biquad_state_[axis]);
+        data = target;
+    }
+    if (decimation_ > 1) {
+        // len 为输出样本数，每个输出消耗 decimation 个输入
+        *count = dsps_fird_f32(&fir_[axis], data, output_[axis], *count / decimation_);
+        data = output_[axis];
+    }
+    return data;
+}
@@ -0,0 +1,162 @@
+#include "SpectralBaseline.hpp"
+#include "DSPMemory.hpp"
+#include "FastMath.hpp"
+#include "Storage.hpp"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+SpectralBaseline::~SpectralBaseline()
+{
+    for (int channel = 0; channel < CHANNELS; channel++) {
+        heap_caps_free(bins_[channel]);
+    }
+}
+
+esp_err_t SpectralBaseline::setBins(int bins)
+{
+    if (bins > MAX_BINS) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    for (int channel = 0; channel < CHANNELS; channel++) {
+        if (bins_[channel] == nullptr) {
+            bins_[channel] = dspAlloc<Bin>(MAX_BINS);
+            if (bins_[channel] == nullptr) {
+                return ESP_ERR_NO_MEM;
+            }
+        }
+    }
+    bin_count_ = bins;
+    reset();
+    return ESP_OK;
+}
+
+float SpectralBaseline::toDb(float psd)
+{
+    return fastPowerDb(psd + PSD_FLOOR);
+}
+
+SpectralBaseline::StoredBin SpectralBaseline::quantize(const Bin& bin)
+{
+    StoredBin stored;
+    stored.mean = (int16_t)lrintf(fminf(fmaxf(bin.mean * MEAN_SCALE, -32768.0f), 32767.0f));
+    stored.var = (uint16_t)lrintf(fminf(fmaxf(bin.var * VAR_SCALE, 0.0f), 65535.0f));
+    return stored;
+}
+
+SpectralBaseline::Bin SpectralBaseline::dequantize(const StoredBin& stored)
+{
+    return { stored.mean / MEAN_SCALE, stored.var / VAR_SCALE };
+}
+
+void SpectralBaseline::reset()
+{
+    for (int channel = 0; channel < CHANNELS && bins_[channel] != nullptr; channel++) {
+        memset(bins_[channel], 0, bin_count_ * sizeof(Bin));
+    }
+    count_ = 0;
+}
+
+void SpectralBaseline::filePath(char* path, size_t size) const
+{
+    snprintf(path, size, FILE_PATH_FORMAT, bin_count_);
+}
+
+float SpectralBaseline::score(int channel, const float* psd, float* peak_z) const
+{
+    float sum = 0;
+    float peak = 0;
+    for (int i = 0; i < bin_count_; i++) {
+        const Bin& bin = bins_[channel][i];
+        const float d = toDb(psd[i]) - bin.mean;
+        const float z2 = d * d / (bin.var + VAR_FLOOR);
+        sum += z2;
+        if (d > 0 && z2 > peak) {
+            peak = z2;
+        }
+    }
+    *peak_z = sqrtf(peak);
+    return sqrtf(sum / bin_count_);
+}
+
+void SpectralBaseline::update(int channel, const float* psd)
+{
+    // 方差形式的 Welford：mean_n = mean + d/n，var_n = var + (d * (x - mean_n) - var)/n
+    const float n = (float)(count_ < BASELINE_MAX_COUNT ? count_ + 1 : BASELINE_MAX_COUNT);
+    for (int i = 0; i < bin_count_; i++) {
+        Bin& bin = bins_[channel][i];
+        const float x = toDb(psd[i]);
+        const float d = x - bin.mean;
+        bin.mean += d / n;
+        bin.var += (d * (x - bin.mean) - bin.var) / n;
+    }
+}
+
+void SpectralBaseline::commitFrame()
+{
+    if (count_ < UINT32_MAX) {
+        count_++;
+    }
+}
+
+// 文件头之后各通道依次存放，量化到临时缓冲区后一次写入
+esp_err_t SpectralBaseline::save(uint32_t sample_rate_hz) const
+{
+    if (bin_count_ == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    StoredBin* stored = dspAlloc<StoredBin>(CHANNELS * bin_count_);
+    if (stored == nullptr) {
+        return ESP_ERR_NO_MEM;
+    }
+    const void* parts[CHANNELS];
+    for (int channel = 0; channel < CHANNELS; channel++) {
+        StoredBin* part = &stored[channel * bin_count_];
+        for (int i = 0; i < bin_count_; i++) {
+            part[i] = quantize(bins_[channel][i]);
+        }
+        parts[channel] = part;
+    }
+    char path[40];
+    filePath(path, sizeof(path));
+    FileHeader header = { FILE_MAGIC, FILE_VERSION, CHANNELS, (uint16_t)bin_count_, 0, sample_rate_hz, count_ };
+    esp_err_t ret = Storage::writeFile(path, &header, sizeof(header), parts, bin_count_ * sizeof(StoredBin), CHANNELS);
+    heap_caps_free(stored);
+    return ret;
+}
+
+esp_err_t SpectralBaseline::load(uint32_t sample_rate_hz)
+{
+    if (bin_count_ == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    StoredBin* stored = dspAlloc<StoredBin>(CHANNELS * bin_count_);
+    if (stored == nullptr) {
+        return ESP_ERR_NO_MEM;
+    }
+    char path[40];
+    filePath(path, sizeof(path));
+    FileHeader header = {};
+    void* parts[CHANNELS];
+    for (int channel = 0; channel < CHANNELS; channel++) {
+        parts[channel] = &stored[channel * bin_count_];
+    }
+    esp_err_t ret = Storage::readFile(path, &header, sizeof(header), parts, bin_count_ * sizeof(StoredBin), CHANNELS);
+    if (ret == ESP_OK && (header.magic != FILE_MAGIC || header.version != FILE_VERSION || header.channels != CHANNELS
+        || header.bins != bin_count_ || header.sample_rate_hz != sample_rate_hz)) {
+        ret = ESP_ERR_INVALID_VERSION; // 采样率或 FFT 点数变了，旧基线不再适用
+    }
+    if (ret != ESP_OK) {
+        heap_caps_free(stored);
+        reset();
+        return ret;
+    }
+    for (int channel = 0; channel < CHANNELS; channel++) {
+        for (int i = 0; i < bin_count_; i++) {
+            bins_[channel][i] = dequantize(stored[channel * bin_count_ + i]);
+        }
+    }
+    heap_caps_free(stored);
+    count_ = header.count;
+    return ESP_OK;
+}
@@ -0,0 +1,130 @@
+#include "SpectralFeatures.hpp"
+#include "FastMath.hpp"
+#include <math.h>
+#include <string.h>
+
+void SpectralFeatureExtractor::setBands(const FeatureBand* bands, int count)
+{
+    band_count_ = count > SPECTRAL_MAX_BANDS ? SPECTRAL_MAX_BANDS : count;
+    memcpy(bands_, bands, band_count_ * sizeof(FeatureBand));
+}
+
+void SpectralFeatureExtractor::setDefaultBands(uint32_t sample_rate_hz)
+{
+    const float width = sample_rate_hz / 2.0f / SPECTRAL_MAX_BANDS;
+    for (int i = 0; i < SPECTRAL_MAX_BANDS; i++) {
+        bands_[i].low_hz = i * width;
+        bands_[i].high_hz = (i + 1) * width;
+    }
+    band_count_ = SPECTRAL_MAX_BANDS;
+}
+
+// 对第 k 个频点及其左右邻点的对数幅值做抛物线拟合，返回以频点为单位的峰值位置
+float SpectralFeatureExtractor::interpolatePeak(const float* psd, int bins, int k, float* peak_psd)
+{
+    *peak_psd = psd[k];
+    if (k <= 0 || k >= bins - 1) {
+        return k;
+    }
+    const float a = fastLog2(psd[k - 1] + 1e-20f);
+    const float b = fastLog2(psd[k] + 1e-20f);
+    const float c = fastLog2(psd[k + 1] + 1e-20f);
+    const float denom = a - 2 * b + c;
+    if (denom >= 0) {
+        return k; // 不是严格的极大值，无法插值
+    }
+    const float delta = 0.5f * (a - c) / denom;
+    *peak_psd = exp2f(b - 0.25f * (a - c) * delta);
+    return k + delta;
+}
+
+void SpectralFeatureExtractor::findPeaks(const float* psd, int bins, float df, SpectralFeatures::Peak* peaks)
+{
+    memset(peaks, 0, SPECTRAL_TOP_K * sizeof(SpectralFeatures::Peak));
+    for (int k = 1; k < bins; k++) {
+        const float p = psd[k];
+        const bool is_peak = (p > psd[k - 1]) && (k == bins - 1 || p >= psd[k + 1]);
+        if (!is_peak || p <= peaks[SPECTRAL_TOP_K - 1].psd) {
+            continue;
+        }
+        // 插入排序维护前 K 大
+        int pos = SPECTRAL_TOP_K - 1;
+        while (pos > 0 && peaks[pos - 1].psd < p) {
+            peaks[pos] = peaks[pos - 1];
+            pos--;
+        }
+        peaks[pos].psd = p;
+        peaks[pos].freq_hz = k; // 先记频点号，最后统一插值
+    }
+    for (int i = 0; i < SPECTRAL_TOP_K && peaks[i].psd > 0; i++) {
+        float peak_psd;
+        peaks[i].freq_hz = interpolatePeak(psd, bins, (int)peaks[i].freq_hz, &peak_psd) * df;
+        peaks[i].psd = peak_psd;
+    }
+}
+
+void SpectralFeatureExtractor::extract(const float* psd, int bins, uint32_t sample_rate_hz,
+    const float* samples, int length, SpectralFeatures* features)
+{
+    memset(features, 0, sizeof(SpectralFeatures));
+    const float df = (float)sample_rate_hz / (2 * bins);
+
+    // 1. 主频、前 K 个局部峰值和频谱质心，跳过 DC
+    int dominant = 1;
+    float weighted_sum = 0;
+    float total = 0;
+    for (int k = 1; k < bins; k++) {
+        const float p = psd[k];
+        weighted_sum += k * df * p;
+        total += p;
+        if (p > psd[dominant]) {
+            dominant = k;
+        }
+    }
+    findPeaks(psd, bins, df, features->peaks);
+    features->dominant_freq_hz = interpolatePeak(psd, bins, dominant, &features->dominant_psd) * df;
+    features->centroid_hz = total > 0 ? weighted_sum / total : 0;
+
+    // 2. 频带能量
+    for (int b = 0; b < band_count_; b++) {
+        int lo = (int)ceilf(bands_[b].low_hz / df);
+        int hi = (int)ceilf(bands_[b].high_hz / df);
+        if (hi > bins) {
+            hi = bins;
+        }
+        float energy = 0;
+        for (int k = lo < 0 ? 0 : lo; k < hi; k++) {
+            energy += psd[k];
+        }
+        features->band_energy[b] = energy * df;
+    }
+
+    // 3. 时域统计量
+    extractTimeDomain(samples, length, features);
+}
+
+void SpectralFeatureExtractor::extractTimeDomain(const float* samples, int length, SpectralFeatures* features)
+{
+    float mean = 0;
+    for (int i = 0; i < length; i++) {
+        mean += samples[i];
+    }
+    mean /= length;
+    float m2 = 0;
+    float m4 = 0;
+    float peak = 0;
+    for (int i = 0; i < length; i++) {
+        const float d = samples[i] - mean;
+        const float d2 = d * d;
+        m2 += d2;
+        m4 += d2 * d2;
+        if (fabsf(d) > peak) {
+            peak = fabsf(d);
+        }
+    }
+    m2 /= length;
+    m4 /= length;
+    features->rms = sqrtf(m2);
+    features->crest_factor = features->rms > 0 ? peak / features->rms : 0;
+    features->kurtosis = m2 > 0 ? m4 / (m2 * m2) : 0;
+}
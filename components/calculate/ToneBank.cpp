@@ -0,0 +1,52 @@
+#include "ToneBank.hpp"
+#include <math.h>
+#include <string.h>
+
+void ToneBank::configure(const ToneSpec* tones, int count, uint32_t sample_rate_hz, int window)
+{
+    tone_count_ = count > TONE_BANK_MAX_TONES ? TONE_BANK_MAX_TONES : count;
+    memcpy(tones_, tones, tone_count_ * sizeof(ToneSpec));
+    amplitude_scale_ = 2.0f / window;
+    const float r_window = powf(DAMPING, window);
+    for (int t = 0; t < tone_count_; t++) {
+        const float w = 2 * M_PI * tones_[t].freq_hz / sample_rate_hz;
+        state_[t].c_re = DAMPING * cosf(w);
+        state_[t].c_im = -DAMPING * sinf(w);
+        state_[t].d_re = r_window * cosf(w * window);
+        state_[t].d_im = -r_window * sinf(w * window);
+    }
+    reset();
+}
+
+void ToneBank::reset()
+{
+    for (int t = 0; t < tone_count_; t++) {
+        state_[t].s_re = 0;
+        state_[t].s_im = 0;
+    }
+}
+
+float ToneBank::getAmplitude(int i) const
+{
+    return amplitude_scale_ * sqrtf(state_[i].s_re * state_[i].s_re + state_[i].s_im * state_[i].s_im);
+}
+
+bool ToneBank::hasTriggers() const
+{
+    for (int t = 0; t < tone_count_; t++) {
+        if (tones_[t].threshold > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int ToneBank::findTriggered() const
+{
+    for (int t = 0; t < tone_count_; t++) {
+        if (tones_[t].threshold > 0 && getAmplitude(t) >= tones_[t].threshold) {
+            return t;
+        }
+    }
+    return -1;
+}
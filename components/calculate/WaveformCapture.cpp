@@ -0,0 +1,135 @@
+#include "WaveformCapture.hpp"
+#include "DSPMemory.hpp"
+#include "esp_timer.h"
+#include <string.h>
+
+WaveformCapture::~WaveformCapture()
+{
+    heap_caps_free(ring_);
+    heap_caps_free(slots_);
+    if (ready_queue_ != nullptr) {
+        vQueueDelete(ready_queue_);
+    }
+}
+
+esp_err_t WaveformCapture::init(uint32_t sample_rate_hz, float scale)
+{
+    sample_rate_hz_ = sample_rate_hz;
+    scale_ = scale;
+    ring_ = dspAlloc<int16_t>(DSP_AXES * PRE);
+    slots_ = dspAlloc<uint8_t>(SLOTS * SLOT_BYTES);
+    ready_queue_ = xQueueCreate(SLOTS, sizeof(int));
+    if (ring_ == nullptr || slots_ == nullptr || ready_queue_ == nullptr) {
+        ESP_LOGE(TAG, "Failed to allocate %u bytes for capture", (unsigned)(SLOTS * SLOT_BYTES));
+        heap_caps_free(ring_);
+        heap_caps_free(slots_);
+        ring_ = nullptr;
+        slots_ = nullptr;
+        return ESP_ERR_NO_MEM;
+    }
+    for (int slot = 0; slot < SLOTS; slot++) {
+        slot_state_[slot].store(SLOT_FREE);
+    }
+    ESP_LOGI(TAG, "capture %d+%d samples x %d slots, %u bytes per slot", PRE, POST, SLOTS, (unsigned)SLOT_BYTES);
+    return ESP_OK;
+}
+
+void WaveformCapture::trigger(capture_trigger_t type, int axis)
+{
+    pending_axis_.store(axis);
+    pending_trigger_.store(type);
+}
+
+// 找一个空闲槽，把环形缓冲区里最近的 PRE 个样本按时间顺序拷进去，之后的样本写入触发后区域
+void WaveformCapture::startCapture(capture_trigger_t type, int axis)
+{
+    int slot = -1;
+    for (int s = 0; s < SLOTS; s++) {
+        if (slot_state_[s].load(std::memory_order_acquire) == SLOT_FREE) {
+            slot = s;
+            break;
+        }
+    }
+    if (slot < 0) {
+        dropped_triggers_.fetch_add(1, std::memory_order_relaxed); // 上传还没跟上，放弃这次触发
+        return;
+    }
+    slot_state_[slot].store(SLOT_FILLING, std::memory_order_relaxed);
+
+    CaptureHeader* header = slotHeader(slot);
+    header->magic = CAPTURE_MAGIC;
+    header->version = CAPTURE_VERSION;
+    header->axes = DSP_AXES;
+    header->trigger = type;
+    header->trigger_axis = axis;
+    header->sequence = sequence_++;
+    header->sample_rate_hz = sample_rate_hz_;
+    header->pre_samples = PRE;
+    header->post_samples = POST;
+    header->trigger_time_us = esp_timer_get_time();
+    header->scale = scale_;
+
+    // ring_pos_ 处是最旧的样本
+    const int tail = PRE - ring_pos_;
+    for (int a = 0; a < DSP_AXES; a++) {
+        int16_t* dst = slotSamples(slot, a);
+        const int16_t* src = ring_ + a * PRE;
+        memcpy(dst, src + ring_pos_, tail * sizeof(int16_t));
+        memcpy(dst + tail, src, ring_pos_ * sizeof(int16_t));
+    }
+    filling_slot_ = slot;
+    post_pos_ = 0;
+}
+
+void WaveformCapture::pushSample(const int16_t* sample)
+{
+    for (int axis = 0; axis < DSP_AXES; axis++) {
+        ring_[axis * PRE + ring_pos_] = sample[axis];
+        mean_[axis] += MEAN_ALPHA * (sample[axis] - mean_[axis]);
+        last_[axis] = sample[axis];
+    }
+    ring_pos_ = (ring_pos_ + 1) % PRE;
+}
+
+WaveformCapture::capture_trigger_t WaveformCapture::checkSample(const int16_t* sample, int* axis) const
+{
+    const float threshold = config_.threshold_msq / scale_;
+    const float slope = config_.slope_msq / scale_;
+    for (int a = 0; a < DSP_AXES; a++) {
+        if (config_.threshold_msq > 0 && fabsf(sample[a] - mean_[a]) >= threshold) {
+            *axis = a;
+            return TRIGGER_THRESHOLD;
+        }
+        if (config_.slope_msq > 0 && fabsf((float)sample[a] - last_[a]) >= slope) {
+            *axis = a;
+            return TRIGGER_SLOPE;
+        }
+    }
+    return TRIGGER_NONE;
+}
+
+WaveformCapture::capture_trigger_t WaveformCapture::checkBlockRms(const float* block_mean_square, int* axis) const
+{
+    if (config_.rms_jump_ratio <= 0) {
+        return TRIGGER_NONE;
+    }
+    const float ratio_square = config_.rms_jump_ratio * config_.rms_jump_ratio;
+    for (int a = 0; a < DSP_AXES; a++) {
+        if (block_mean_square[a] > ratio_square * mean_square_[a] && mean_square_[a] > 0) {
+            *axis = a;
+            return TRIGGER_RMS_JUMP;
+        }
+    }
+    return TRIGGER_NONE;
+}
+
+const uint8_t* WaveformCapture::getSlotData(int slot, size_t* size) const
+{
+    *size = SLOT_BYTES;
+    return slots_ + slot * SLOT_BYTES;
+}
+
+void WaveformCapture::releaseSlot(int slot)
+{
+    slot_state_[slot].store(SLOT_FREE, std::memory_order_release);
+}
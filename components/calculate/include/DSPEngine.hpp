@@ -3,38 +3,163 @@
 #include "APPConfig.h"
 #include "esp_log.h"
 #include "esp_dsp.h"
+#include "esp_timer.h"
+#include "esp_cpu.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "bno055driver.hpp"
+#include "QueueChannel.hpp"
+#include "SpectralFeatures.hpp"
+#include "ToneBank.hpp"
+#include "PreFilter.hpp"
+#include "DSPPipeline.hpp"
+#include "FixedSpectrum.hpp"
+#include "SpectralBaseline.hpp"
+#include "WaveformCapture.hpp"
+#include "EnvelopeAnalyzer.hpp"
+#include "FFTPlanCache.hpp"
+#include <atomic>
 #include <memory>
 #include <math.h>
 
-#define N_SAMPLES 512
+#if DSP_FFT_FIXED_POINT && DSP_DECIMATION != 1
+#error "pre-filter decimation needs the float DSP path"
+#endif
 
 class DSPEngine : public Thread {
 public:
+    enum welch_averaging_t {
+        WELCH_AVG_LINEAR = 0, // 每 averages 段求一次算术平均后输出
+        WELCH_AVG_EXPONENTIAL = 1, // 权重 1/averages 的指数平均，每 averages 段输出一次
+    };
+    enum dsp_mode_t {
+        MODE_CONTINUOUS = 0, // 每个 hop 都做 FFT，频率监测组同时运行
+        MODE_TONE_TRIGGERED = 1, // 平时只运行频率监测组，监测频率超过阈值后做 FFT 直到输出一次 Welch 平均
+    };
+    struct WelchConfig {
+        float overlap; // 相邻段的重叠率，0.5f 为 50% 重叠，0.75f 为 75% 重叠；步进按当前点数换算
+        welch_averaging_t averaging;
+        int averages;
+    };
+
     DSPEngine(std::shared_ptr<Bno055Driver> bno055) : 
             Thread("DSPEngine", 1024 * 10, PRIO_FFT, 1), 
             bno055(std::move(bno055)) { };
-    ~DSPEngine() = default;
+    ~DSPEngine();
     
     void run() override;
+    float getOverlapRatio() const { return overlap_ratio_; }
+    void setWelchConfig(const WelchConfig& config); // 需在 start() 之前调用
+    void setFeatureBands(const FeatureBand* bands, int count); // 需在 start() 之前调用，不设置则等分 0 ~ fs/2
+    QueueChannel<SpectralFeatures>& getFeaturesChannel() { return features_channel_; }
+    void setPreFilter(float highpass_cutoff_hz, int decimation); // 需在 start() 之前调用，仅浮点模式
+    void setEnvelope(float band_low_hz, float band_high_hz, int decimation); // 需在 start() 之前调用，仅浮点模式
+    uint32_t getSpectrumRateHz() const { return sample_rate_hz_; } // 抽取后的采样率，频率轴以此为准
+    void setTones(const ToneSpec* tones, int count); // 需在 start() 之前调用
+    void setMode(dsp_mode_t mode) { mode_.store(mode); }
+    dsp_mode_t getMode() const { return mode_.load(); }
+    float getToneAmplitude(int i) const { return tone_bank_.getAmplitude(i); }
+    void resetBaseline() { baseline_reset_requested_.store(true); } // 设备检修或更换后重新学习
+    WaveformCapture& getCapture() { return capture_; }
+    // 任意任务可调用，在两块数据之间生效；点数须为 2 的幂且在 DSP_FFT_MIN_SAMPLES ~ DSP_FFT_MAX_SAMPLES 之间
+    // 切换后历史与平均重新开始，基线按点数分别保存，切回原来的点数时重新读入
+    esp_err_t requestFFTSize(int n);
+    int getFFTSize() const { return fft_size_; }
 
 private:
     std::shared_ptr<Bno055Driver> bno055;
 
     static constexpr auto TAG = "DSPEngine";
-    static constexpr int N = N_SAMPLES;
-    
-    alignas(16) float input_buffers_[2][N]; 
-    int write_buffer_idx_ = 0;  // 当前正在写入哪个 buffer (0 或 1)
-    int write_sample_idx_ = 0;  // 当前写到了第几个点
-    alignas(16) float wind_[N_SAMPLES];         // 窗函数系数
-    alignas(16) float y_cf_[N_SAMPLES * 2];     // 复数工作数组
+    static constexpr int MAX_N = DSP_FFT_MAX_SAMPLES;
+    static constexpr int MAX_BINS = DSP_FFT_MAX_SAMPLES / 2;
+    static constexpr int AXES = DSP_AXES;
+    static constexpr int CHANNELS = DSP_AXES + 1; // 各轴谱之后多一路矢量合成谱
+    int fft_size_ = N_SAMPLES; // 当前 FFT 点数
+    int bins_ = N_SAMPLES / 2;
+    std::atomic<int> requested_fft_size_ { 0 }; // 0 表示没有待切换的点数
+
+    // 所有多轴缓冲区都按结构数组 (SoA) 存放，每轴一行，行首 16 字节对齐，满足 esp-dsp aes3 内核要求
+    // 各行按最大点数在 allocateBuffers() 中一次分配（启用 PSRAM 时在 PSRAM），只用前 fft_size_ 或 bins_ 个
+#if DSP_FFT_FIXED_POINT
+    // 定点模式：窗为 Q15，输入为原始 s16，FFT 工作数组按 sc16 使用
+    FixedSpectrum<DSP_FFT_MAX_SAMPLES> spectrum_;        // Q15 窗、sc16 FFT 与浮点周期图，各轴共用
+    int16_t* y_cf_[DSP_AXES] = {};                       // 各轴 sc16 FFT 工作数组，按 N/2 个复数使用
+    int16_t* history_[DSP_AXES] = {};                    // 各轴最近 N 个原始样本的环形历史
+    float sample_scale_ = 1.0f;                          // 原始 s16 到物理量的比例系数
+#else
+    // 各轴依次经过同一条处理链，链内各级原地复用一块 N 点缓冲区；窗函数与这块缓冲区留在对象内
+    using AxisPipeline = Pipeline<Window<HannShape, DSP_FFT_MAX_SAMPLES>, RealFFT<DSP_FFT_MAX_SAMPLES>, Periodogram<DSP_FFT_MAX_SAMPLES>>;
+    AxisPipeline pipeline_;
+    float* history_[DSP_AXES] = {};                      // 各轴最近 N 个样本的环形历史，供重叠分段使用
+#endif
+    float* samples_ = nullptr;                           // 换算成物理量的时域样本，供特征提取使用
+    float* power_[DSP_AXES] = {};                        // 当前段各轴的周期图
+    float* psd_acc_[DSP_AXES] = {};                      // 线性平均累加器
+    float* psd_avg_[DSP_AXES + 1] = {};                  // Welch 平均后的功率谱密度，最后一行为矢量合成谱
+    int welch_segments_ = 0;
+    WelchConfig welch_config_ = { WELCH_OVERLAP, WELCH_AVERAGING, WELCH_AVERAGES };
+    int hop_ = DSP_BLOCK_SAMPLES; // 当前点数下的段间步进点数，每次切换点数时由重叠率重新换算
+    SpectralFeatureExtractor feature_extractor_;
+    QueueChannel<SpectralFeatures> features_channel_ { FEATURES_CHANNEL_DEPTH,
+        { FEATURES_CHANNEL_OVERFLOW, pdMS_TO_TICKS(FEATURES_CHANNEL_TIMEOUT_MS), 1 } };
+    ToneSpec pending_tones_[TONE_BANK_MAX_TONES] = {}; // start() 之前设置，run() 中按采样率配置
+    int pending_tone_count_ = 0;
+    ToneBank tone_bank_;
+    std::atomic<dsp_mode_t> mode_ { DSP_MODE };
+    bool fft_triggered_ = false; // 触发模式下正在补做 FFT
+    SpectralBaseline baseline_;
+    std::atomic<bool> baseline_reset_requested_ { false };
+    int baseline_unsaved_ = 0; // 上次保存后基线更新的次数
+    WaveformCapture capture_; // 原始采样率下的触发波形捕获，在预处理之前取样
+    void updateBaseline(bool anomalous);
     
     bool fft_initialized_ = false;
+    uint32_t sample_rate_hz_ = SENSOR_SAMPLE_RATE_HZ; // 采集采样率除以抽取比，用于频率轴
+#if !DSP_FFT_FIXED_POINT
+    PreFilter pre_filter_;
+    float highpass_cutoff_hz_ = DSP_HPF_CUTOFF_HZ;
+    int decimation_ = DSP_DECIMATION;
+    EnvelopeAnalyzer envelope_; // 原始采样率下的包络分析，FFT 借用 pipeline_
+    float envelope_band_hz_[2] = { ENVELOPE_BAND_LOW_HZ, ENVELOPE_BAND_HIGH_HZ };
+    int envelope_decimation_ = ENVELOPE_DECIMATION;
+    void analyzeEnvelope();
+#endif
+
+    // 计算与采集重叠程度统计：处理第 k 块期间生产者仍在写第 k+1 块的时间占比
+    // 计算期间写入的样本数乘采样周期即生产者在这段时间里实际采集的时长，不超过计算时长
+    static constexpr int STATS_REPORT_FRAMES = 10;
+    int64_t compute_us_ = 0;
+    int64_t overlap_us_ = 0;
+    int stats_frames_ = 0;
+    float overlap_ratio_ = 0;
+    void updateOverlapStats(int64_t start_us, int64_t end_us, uint32_t samples_written);
+
+    // 各处理阶段的 CPU 周期数，与重叠统计一起按 STATS_REPORT_FRAMES 帧平均后打印
+    // 加窗、FFT、周期图与 Welch 都是逐轴的，各轴之间没有可共享的计算，三轴约为单轴的 3.5 倍，
+    // 特征提取多了矢量通道约为 4 倍；最初 2 倍以内的目标达不到，按此接受。主机上的对比见 host_test/bench_dsp_stages.cpp
+    enum stage_t {
+        STAGE_FILTER = 0,
+        STAGE_TONES,
+        STAGE_ENVELOPE,
+        STAGE_WINDOW,
+        STAGE_FFT,
+        STAGE_POWER,
+        STAGE_WELCH,
+        STAGE_FEATURES,
+        STAGE_COUNT,
+    };
+    uint32_t stage_cycles_[STAGE_COUNT] = {};
+    uint32_t stampStage(stage_t stage, uint32_t start_cycles);
+    void logStageCycles();
     
-    // FFT 处理并显示频谱
-    // TODO: 后面再实现对频谱的分析
-    void processAndShow(float* data, int length);
+    // FFT 处理得到周期图，Welch 平均后提取特征上报
+    esp_err_t allocateBuffers();
+    esp_err_t configureFFTSize(int n);
+    esp_err_t initWindowAndFFT();
+    bool accumulateWelch();
+    void resetWelch();
+    int welchHop(int n) const;
+    bool shouldRunFFT();
+    void publishFeatures();
+    const float* timeDomainSamples(int channel);
 };
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+#include "esp_heap_caps.h"
+#include "sdkconfig.h"
+#include <stddef.h>
+
+// 大块工作缓冲区（历史、平均谱、基线、捕获槽）：启用 PSRAM 时放在 PSRAM，否则放在内部 RAM
+// 旋转因子表每次 FFT 都要反复访问，始终放在内部 SRAM
+#if CONFIG_SPIRAM
+#define DSP_WORK_MALLOC_CAPS (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+#else
+#define DSP_WORK_MALLOC_CAPS (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+#endif
+#define DSP_HOT_MALLOC_CAPS (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+
+// 16 字节对齐并清零，满足 esp-dsp aes3 内核要求；用 heap_caps_free 释放
+template <typename T>
+T* dspAlloc(size_t count, uint32_t caps = DSP_WORK_MALLOC_CAPS)
+{
+    return static_cast<T*>(heap_caps_aligned_calloc(16, count, sizeof(T), caps));
+}
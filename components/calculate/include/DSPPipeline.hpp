@@ -0,0 +1,285 @@
+#pragma once
+#include "esp_err.h"
+#include "esp_dsp.h"
+#include "FFTPlanCache.hpp"
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <tuple>
+#include <utility>
+
+// 编译期组合的处理链：Pipeline<Window<HannShape, N>, RealFFT<N>, Periodogram<N>>
+// 每一级都是普通类型，没有虚函数；缓冲区容量、哪几级原地复用同一块缓冲区都在编译期确定
+// 模板参数 N 是最大点数（容量），实际点数由 ctx.fft_size 在 init 时给出，重新 init 即可切换点数
+// 各级的 process 都在头文件内联，相邻循环交给编译器合并，调用方通过 probe 回调在级间插入计时，空回调没有开销
+//
+// 一级需要提供：
+//   static constexpr int input_size / output_size  输入输出的 float 个数上限
+//   static constexpr bool in_place                 输出能否覆盖输入
+//   esp_err_t init(PipelineContext& ctx)           按顺序调用，前级可以把参数写进 ctx 留给后级
+//   void process(const float* in, float* out)      in_place 时 in == out
+
+struct PipelineContext {
+    uint32_t sample_rate_hz;
+    int fft_size; // 实际点数，不超过各级的容量
+    float window_power; // sum(w^2)，由窗函数级写入，功率谱密度级使用
+};
+
+// 环形历史缓冲区的一次读取：从 start 开始是最旧的样本，到末尾后回绕
+struct RingInput {
+    const float* data;
+    int start;
+};
+
+// 实数 FFT 的拆分：N/2 点复数 FFT 的结果拆成 N 点实数序列的前半个频谱
+// z[n] = x[2n] + j*x[2n+1]，Fe/Fo 分别是偶数点和奇数点序列的频谱，X[k] = Fe[k] + W^k * Fo[k]
+// 旋转因子取自 FFTPlanCache 按最大点数生成的共享表
+class RealSplit {
+public:
+    esp_err_t init(int n)
+    {
+        n_ = n;
+        stride_ = FFTPlanCache::splitStride(n) * 2;
+        w_ = FFTPlanCache::splitTwiddles();
+        return (w_ != nullptr) ? ESP_OK : ESP_ERR_NO_MEM;
+    }
+
+    // k 与 N/2-k 成对处理，xk/xm 各为一个复数 (实部, 虚部)
+    inline void pair(int k, float zk_re, float zk_im, float zm_re, float zm_im, float* xk, float* xm) const
+    {
+        // Fe = (Z[k] + conj(Z[m])) / 2, Fo = -j * (Z[k] - conj(Z[m])) / 2
+        const float fe_re = 0.5f * (zk_re + zm_re);
+        const float fe_im = 0.5f * (zk_im - zm_im);
+        const float fo_re = 0.5f * (zk_im + zm_im);
+        const float fo_im = -0.5f * (zk_re - zm_re);
+
+        // t = W^k * Fo
+        const float w_re = w_[k * stride_ + 0];
+        const float w_im = w_[k * stride_ + 1];
+        const float t_re = w_re * fo_re - w_im * fo_im;
+        const float t_im = w_re * fo_im + w_im * fo_re;
+
+        // X[k] = Fe + t, X[m] = conj(Fe - t)
+        xk[0] = fe_re + t_re;
+        xk[1] = fe_im + t_im;
+        xm[0] = fe_re - t_re;
+        xm[1] = t_im - fe_im;
+    }
+
+    // 原地拆分；DC 与 Nyquist 均为实数，Nyquist 存放在 data[1]
+    void apply(float* data) const
+    {
+        const int half = n_ / 2;
+        const float z0_re = data[0];
+        const float z0_im = data[1];
+        data[0] = z0_re + z0_im;
+        data[1] = z0_re - z0_im;
+        for (int k = 1; k <= half / 2; k++) {
+            const int m = half - k;
+            pair(k, data[k * 2 + 0], data[k * 2 + 1], data[m * 2 + 0], data[m * 2 + 1], &data[k * 2], &data[m * 2]);
+        }
+    }
+
+private:
+    const float* w_ = nullptr;
+    int n_ = 0;
+    int stride_ = 0; // 共享表中相邻两个旋转因子的间隔 (float 个数)
+};
+
+// 窗函数形状
+struct HannShape {
+    static void generate(float* window, int length) { dsps_wind_hann_f32(window, length); }
+};
+
+// 加窗：输出直接按 N/2 个复数排列，相邻两个实数样本就是一个复数的实部和虚部，不需要单独的打包步骤
+template <typename Shape, int N>
+class Window {
+public:
+    static constexpr int input_size = N;
+    static constexpr int output_size = N;
+    static constexpr bool in_place = true;
+
+    esp_err_t init(PipelineContext& ctx)
+    {
+        if (ctx.fft_size > N) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        size_ = ctx.fft_size;
+        Shape::generate(coeffs_, size_);
+        ctx.window_power = 0;
+        for (int i = 0; i < size_; i++) {
+            ctx.window_power += coeffs_[i] * coeffs_[i];
+        }
+        return ESP_OK;
+    }
+
+    void process(const float* in, float* out) { dsps_mul_f32(in, coeffs_, out, size_, 1, 1, 1); }
+
+    // 从环形历史读取：分两段与窗函数相乘即可，无需先摆正
+    void process(const RingInput& in, float* out)
+    {
+        const int tail = size_ - in.start;
+        dsps_mul_f32(&in.data[in.start], coeffs_, out, tail, 1, 1, 1);
+        if (in.start > 0) {
+            dsps_mul_f32(in.data, &coeffs_[tail], &out[tail], in.start, 1, 1, 1);
+        }
+    }
+
+private:
+    alignas(16) float coeffs_[N];
+    int size_ = N;
+};
+
+// N 点实数 FFT：N/2 点复数 FFT + 位反转 + 拆分，输出 0 ~ N/2-1 号频点，Nyquist 存放在 [1]
+// 复数 FFT 表与拆分旋转因子都来自 FFTPlanCache，切换点数不重新生成
+template <int N>
+class RealFFT {
+public:
+    static constexpr int input_size = N;
+    static constexpr int output_size = N;
+    static constexpr bool in_place = true;
+    static_assert(N <= FFTPlanCache::MAX_SIZE, "FFT capacity exceeds the shared table size");
+
+    esp_err_t init(PipelineContext& ctx)
+    {
+        if (ctx.fft_size > N) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        size_ = ctx.fft_size;
+        esp_err_t ret = FFTPlanCache::initFloat();
+        return (ret == ESP_OK) ? split_.init(size_) : ret;
+    }
+
+    void process(const float*, float* data)
+    {
+        dsps_fft2r_fc32(data, size_ / 2);
+        dsps_bit_rev_fc32(data, size_ / 2);
+        split_.apply(data);
+    }
+
+private:
+    RealSplit split_;
+    int size_ = N;
+};
+
+// 单边周期图：功率谱密度 = |X|^2 / (fs * sum(w^2))，除 DC 外乘 2
+// 第 i 个输出只读 [2i, 2i+1]，顺序写回不会覆盖未读的输入，可以原地进行
+template <int N>
+class Periodogram {
+public:
+    static constexpr int input_size = N;
+    static constexpr int output_size = N / 2;
+    static constexpr bool in_place = true;
+
+    esp_err_t init(PipelineContext& ctx)
+    {
+        bins_ = ctx.fft_size / 2;
+        psd_scale_ = 1.0f / (ctx.sample_rate_hz * ctx.window_power);
+        return ESP_OK;
+    }
+
+    void process(const float* in, float* out)
+    {
+        out[0] = in[0] * in[0] * psd_scale_; // in[1] 存的是 Nyquist，不属于 DC
+        for (int i = 1; i < bins_; i++) {
+            const float real = in[i * 2 + 0];
+            const float imag = in[i * 2 + 1];
+            out[i] = 2 * (real * real + imag * imag) * psd_scale_;
+        }
+    }
+
+private:
+    float psd_scale_ = 0;
+    int bins_ = N / 2;
+};
+
+template <typename... Stages>
+class Pipeline {
+public:
+    static constexpr size_t STAGE_COUNT = sizeof...(Stages);
+    static_assert(STAGE_COUNT > 0, "pipeline needs at least one stage");
+
+    esp_err_t init(PipelineContext& ctx)
+    {
+        esp_err_t ret = ESP_OK;
+        std::apply([&](auto&... stage) { ((ret = (ret == ESP_OK) ? stage.init(ctx) : ret), ...); }, stages_);
+        return ret;
+    }
+
+    // 依次执行各级，返回最后一级输出所在的缓冲区；每级完成后调用 probe(级序号)
+    template <typename Input, typename Probe>
+    const float* run(const Input& input, Probe&& probe) { return runFrom<0>(input, probe); }
+
+    template <typename Input>
+    const float* run(const Input& input)
+    {
+        return run(input, [](size_t) { });
+    }
+
+    template <size_t I>
+    auto& stage() { return std::get<I>(stages_); }
+
+    static constexpr int OUTPUT_SIZE = std::tuple_element_t<STAGE_COUNT - 1, std::tuple<Stages...>>::output_size;
+
+private:
+    static constexpr bool IN_PLACE[] = { Stages::in_place... };
+    static constexpr int INPUT_SIZE[] = { Stages::input_size... };
+    static constexpr int OUTPUT_SIZE_OF[] = { Stages::output_size... };
+
+    // 第 i 级写入哪块缓冲区：第 0 级的输入来自外部，写 0 号；之后原地级沿用上一级的缓冲区，否则换到另一块
+    static constexpr int bufferOf(size_t i)
+    {
+        int buffer = 0;
+        for (size_t s = 1; s <= i; s++) {
+            buffer = IN_PLACE[s] ? buffer : 1 - buffer;
+        }
+        return buffer;
+    }
+    static constexpr bool usesSecondBuffer()
+    {
+        for (size_t s = 0; s < STAGE_COUNT; s++) {
+            if (bufferOf(s) == 1) {
+                return true;
+            }
+        }
+        return false;
+    }
+    static constexpr int maxBufferSize()
+    {
+        int size = 0;
+        for (size_t s = 0; s < STAGE_COUNT; s++) {
+            size = OUTPUT_SIZE_OF[s] > size ? OUTPUT_SIZE_OF[s] : size;
+        }
+        return size;
+    }
+    static constexpr bool chainMatches()
+    {
+        for (size_t s = 1; s < STAGE_COUNT; s++) {
+            if (INPUT_SIZE[s] != OUTPUT_SIZE_OF[s - 1]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    static_assert(chainMatches(), "stage input size must match the previous stage output size");
+
+    static constexpr int BUFFER_COUNT = usesSecondBuffer() ? 2 : 1;
+    static constexpr int BUFFER_SIZE = maxBufferSize();
+
+    std::tuple<Stages...> stages_;
+    alignas(16) float buffers_[BUFFER_COUNT][BUFFER_SIZE];
+
+    template <size_t I, typename Input, typename Probe>
+    const float* runFrom(const Input& input, Probe& probe)
+    {
+        float* out = buffers_[bufferOf(I)];
+        std::get<I>(stages_).process(input, out);
+        probe(I);
+        if constexpr (I + 1 < STAGE_COUNT) {
+            return runFrom<I + 1>(static_cast<const float*>(out), probe);
+        } else {
+            return out;
+        }
+    }
+};
@@ -0,0 +1,61 @@
+#pragma once
+#include "APPConfig.h"
+#include "esp_err.h"
+#include "esp_dsp.h"
+#include "DSPPipeline.hpp"
+#include "SpectralFeatures.hpp"
+#include <stdint.h>
+
+#define ENVELOPE_MAX_DECIMATION 16 // 块大小需能被抽取比整除
+
+// 包络（解调）分析：轴承缺陷表现为高频共振的幅值调制，普通频谱上看不到，包络谱上是故障特征频率及其谐波
+// 带通取出共振带 -> 全波整流 -> 低通得到包络 -> 抽取 -> 去均值后进入环形历史
+// 这里只负责滤波和包络历史，FFT 由 DSP 引擎用已有的处理链完成，不另建旋转因子表与工作缓冲区
+// 按块处理，各轴滤波器状态独立，仅浮点模式；窗长跟随主频谱的 FFT 点数，历史与谱按最大点数分配在工作内存里
+class EnvelopeAnalyzer {
+public:
+    EnvelopeAnalyzer() { };
+    ~EnvelopeAnalyzer();
+
+    // 共振带 [band_low_hz, band_high_hz] 需低于输入奈奎斯特频率，decimation 为 1 ~ 16 的 2 的幂
+    // 每次调用都清空状态，切换 FFT 点数时重新调用；返回 ESP_ERR_INVALID_ARG 时保持关闭
+    esp_err_t configure(uint32_t input_rate_hz, float band_low_hz, float band_high_hz, int decimation, int fft_size);
+    bool isEnabled() const { return enabled_; }
+    uint32_t getOutputRateHz() const { return input_rate_hz_ / decimation_; }
+
+    // 处理一块按结构数组排列的原始样本，各轴 count 个，轴间隔 stride；攒够半个窗长的新包络样本时返回 true
+    bool process(const float* block, int count, int stride);
+    RingInput getHistory(int axis) const { return RingInput { history_[axis], history_pos_ }; }
+
+    // 引擎用共享处理链算出某轴包络的周期图后交回，psd_scale 把按频谱采样率归一化的结果换算到包络采样率
+    void accumulate(int axis, const float* power, float psd_scale);
+    // 各轴都交回后调用：求矢量合成包络谱，更新各通道的峰值
+    void finishSegment();
+    const SpectralFeatures::Peak* getPeaks(int channel) const { return peaks_[channel]; }
+
+private:
+    static constexpr int MAX_N = DSP_FFT_MAX_SAMPLES;
+    static constexpr int CHANNELS = DSP_AXES + 1;
+    static constexpr float MEAN_ALPHA = 1.0f / 256; // 包络均值的指数平均权重 (每个输出样本)
+
+    bool enabled_ = false;
+    uint32_t input_rate_hz_ = VIBRATION_SAMPLE_RATE_HZ;
+    int decimation_ = 1;
+    // 带通 = 二阶高通 + 二阶低通；包络低通为两节级联的四阶巴特沃斯，兼作抽取前的抗混叠
+    float bandpass_coeffs_[2][5] = {};
+    float bandpass_state_[DSP_AXES][2][2] = {};
+    float lowpass_coeffs_[2][5] = {};
+    float lowpass_state_[DSP_AXES][2][2] = {};
+    float mean_[DSP_AXES] = {};
+    alignas(16) float work_[DSP_BLOCK_SAMPLES];
+
+    int n_ = N_SAMPLES;
+    float* history_[DSP_AXES] = {}; // 各轴最近 n_ 个包络样本
+    int history_pos_ = 0;
+    int history_filled_ = 0;
+    int since_last_segment_ = 0;
+
+    float* psd_avg_[CHANNELS] = {}; // 指数平均后的包络谱 (n_/2 个频点)，最后一行为矢量合成
+    int segments_ = 0;
+    SpectralFeatures::Peak peaks_[CHANNELS][SPECTRAL_TOP_K] = {};
+};
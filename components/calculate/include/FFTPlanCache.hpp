@@ -0,0 +1,30 @@
+#pragma once
+#include "APPConfig.h"
+#include "esp_err.h"
+#include <stdint.h>
+
+// 所有 FFT 点数共用一套按 DSP_FFT_MAX_SAMPLES 生成的表，切换点数时不需要重新生成或另外分配：
+// esp-dsp radix-2 的旋转因子表按位反转顺序存放，较小点数的 FFT 直接使用表的前一段
+// 实数拆分的旋转因子 W_N^k = W_max^(k*max/N)，点数为 N 时按 max/N 的步长取用
+// 表放在内部 SRAM，只在第一次使用时分配，之后一直保留
+class FFTPlanCache {
+public:
+    static constexpr int MIN_SIZE = DSP_FFT_MIN_SAMPLES;
+    static constexpr int MAX_SIZE = DSP_FFT_MAX_SAMPLES;
+
+    static bool isValidSize(int n) { return n >= MIN_SIZE && n <= MAX_SIZE && (n & (n - 1)) == 0; }
+
+    // 按精度初始化 esp-dsp 的复数 FFT 表，可以重复调用
+    static esp_err_t initFloat();
+    static esp_err_t initFixed();
+
+    // 实数拆分旋转因子 W_max^k (k = 0 ~ max/4)，按 (实部, 虚部) 交错存放
+    static const float* splitTwiddles();
+    static int splitStride(int n) { return MAX_SIZE / n; }
+
+private:
+    static constexpr auto TAG = "FFTPlanCache";
+    static float* fc32_table_;
+    static int16_t* sc16_table_;
+    static float* split_table_;
+};
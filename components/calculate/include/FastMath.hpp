@@ -0,0 +1,43 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+
+// 快速 log2 / 分贝换算，替代逐频点调用 log10f
+// x = 2^e * m，把 m 归一到 [sqrt(1/2), sqrt(2))，u = m - 1，log2(m) = u * P(u)，P 为 5 次多项式
+// P 在 u ∈ [-0.293, 0.414] 上按最大绝对误差拟合，逼近误差 2.2e-6 (6.5e-6 dB)；只有乘加，没有除法、查表和分支
+// 分贝版本的系数预先乘好 10*log10(2)，少一次对整个结果的乘法舍入；加上 float 舍入后的实测误差见 host_test/test_fast_math.cpp
+// 只处理正的规格化数，x = 0 时返回 -127（约 -382 dB），作为底噪使用
+
+static constexpr float FAST_LOG_DB_PER_LOG2 = 3.01029996f; // 10 * log10(2)
+
+// 拆出 x 的二进制阶 e 与 u = m - 1
+static inline float fastLogSplit(float x, float* u)
+{
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    float exponent = (float)((int)((bits >> 23) & 0xFF) - 127);
+    bits = (bits & 0x007FFFFF) | 0x3F800000; // 尾数，[1, 2)
+    float m;
+    memcpy(&m, &bits, sizeof(m));
+    const bool upper = m > 1.41421356f;
+    m = upper ? m * 0.5f : m;
+    *u = m - 1.0f;
+    return upper ? exponent + 1.0f : exponent;
+}
+
+static inline float fastLog2(float x)
+{
+    float u;
+    const float exponent = fastLogSplit(x, &u);
+    const float p = 1.44271348f + u * (-0.721131858f + u * (0.479348021f + u * (-0.367489994f + u * (0.322154776f + u * -0.20659164f))));
+    return exponent + u * p;
+}
+
+// 功率换算为分贝：10 * log10(power)
+static inline float fastPowerDb(float power)
+{
+    float u;
+    const float exponent = fastLogSplit(power, &u);
+    const float p = 4.34300033f + u * (-2.1708232f + u * (1.44298133f + u * (-1.10625511f + u * (0.969782508f + u * -0.621902805f))));
+    return exponent * FAST_LOG_DB_PER_LOG2 + u * p;
+}
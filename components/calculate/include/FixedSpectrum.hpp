@@ -0,0 +1,81 @@
+#pragma once
+#include "APPConfig.h"
+#include "esp_err.h"
+#include "esp_dsp.h"
+#include "DSPPipeline.hpp"
+#include "FFTPlanCache.hpp"
+#include <math.h>
+#include <stdint.h>
+
+// 定点模式的单轴频谱：原始 s16 样本乘 Q15 窗 -> N/2 点 sc16 复数 FFT -> 浮点实数拆分与周期图
+// 加窗的 Q15 乘法少右移 INPUT_SHIFT 位，即输入左移，用满 int16 的动态范围；sc16 FFT 每级蝶形右移 1 位防溢出，结果整体缩小 N/2 倍
+// 这两处缩放连同物理量比例系数在周期图阶段一次补回，输出与浮点处理链的 Periodogram 同一量纲
+// 每级右移都会丢掉低位，小信号的精度随点数变差：几百 LSB 以上的信号与浮点结果的 SNR 约 50~65 dB，
+// 只有几个 LSB 的信号降到 10~20 dB（host_test/test_fixed_spectrum_accuracy.cpp）
+// 三步分开调用，方便调用方逐级计时；模板参数 N 是最大点数（窗函数容量），实际点数由 init 给出
+template <int N>
+class FixedSpectrum {
+public:
+    static constexpr int INPUT_SHIFT = DSP_Q15_INPUT_SHIFT;
+
+    // scratch 至少 fft_size 个 float，只在生成窗函数时借用；需在采样率确定之后调用
+    esp_err_t init(uint32_t sample_rate_hz, int fft_size, float sample_scale, float* scratch)
+    {
+        if (fft_size > N) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        esp_err_t ret = FFTPlanCache::initFixed();
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        size_ = fft_size;
+        HannShape::generate(scratch, size_);
+        float window_power = 0;
+        for (int i = 0; i < size_; i++) {
+            wind_[i] = (int16_t)fminf(scratch[i] * 32768.0f, 32767.0f);
+            const float w = wind_[i] / 32768.0f; // 按量化后的窗计算归一化系数
+            window_power += w * w;
+        }
+        const float amplitude_scale = (size_ / 2) * sample_scale / (1 << INPUT_SHIFT);
+        psd_scale_ = amplitude_scale * amplitude_scale / (sample_rate_hz * window_power);
+        return split_.init(size_);
+    }
+
+    // 从环形历史加窗，start 开始是最旧的样本；输出直接按 N/2 个复数排列
+    void window(const int16_t* history, int start, int16_t* out) const
+    {
+        const int tail = size_ - start;
+        dsps_mul_s16(&history[start], wind_, out, tail, 1, 1, 1, 15 - INPUT_SHIFT);
+        if (start > 0) {
+            dsps_mul_s16(history, &wind_[tail], &out[tail], start, 1, 1, 1, 15 - INPUT_SHIFT);
+        }
+    }
+
+    void transform(int16_t* data) const
+    {
+        dsps_fft2r_sc16(data, size_ / 2);
+        dsps_bit_rev_sc16_ansi(data, size_ / 2);
+    }
+
+    // 定点结果不原地拆分，拆分与求功率一起用浮点完成；输出 size_/2 个频点的单边功率谱密度
+    void power(const int16_t* data, float* power) const
+    {
+        const int half = size_ / 2;
+        const float dc = (float)data[0] + (float)data[1];
+        power[0] = dc * dc * psd_scale_;
+        for (int k = 1; k <= half / 2; k++) {
+            const int m = half - k;
+            float xk[2];
+            float xm[2];
+            split_.pair(k, data[k * 2 + 0], data[k * 2 + 1], data[m * 2 + 0], data[m * 2 + 1], xk, xm);
+            power[k] = 2 * (xk[0] * xk[0] + xk[1] * xk[1]) * psd_scale_;
+            power[m] = 2 * (xm[0] * xm[0] + xm[1] * xm[1]) * psd_scale_;
+        }
+    }
+
+private:
+    alignas(16) int16_t wind_[N]; // Q15 窗函数系数
+    RealSplit split_;
+    int size_ = N;
+    float psd_scale_ = 0;
+};
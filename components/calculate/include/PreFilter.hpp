@@ -0,0 +1,41 @@
+#pragma once
+#include "APPConfig.h"
+#include "esp_dsp.h"
+#include <stdint.h>
+
+#define PRE_FILTER_MAX_DECIMATION 8 // 块大小需能被抽取比整除
+#define PRE_FILTER_TAPS_PER_RATIO 16 // 抗混叠 FIR 阶数 = 16 * 抽取比
+
+// FFT 前的预处理：二阶高通去除重力与直流，再经抗混叠 FIR 低通按整数比抽取
+// 按块处理，各轴滤波器状态独立；dsps_fird_f32 只在输出时刻计算卷积，运算量与多相结构相同
+class PreFilter {
+public:
+    PreFilter() { };
+    ~PreFilter() { };
+
+    // cutoff_hz <= 0 关闭高通，decimation 为 1/2/4/8，返回 ESP_ERR_INVALID_ARG 表示参数不合法
+    esp_err_t configure(uint32_t input_rate_hz, float cutoff_hz, int decimation);
+    int getDecimation() const { return decimation_; }
+    uint32_t getOutputRateHz() const { return input_rate_hz_ / decimation_; }
+
+    // 处理某一轴的一块输入，返回输出样本的地址，count 传入输入样本数、返回输出样本数
+    // 高通与抽取都关闭时直接返回输入地址，不做拷贝
+    const float* process(int axis, const float* input, int* count);
+
+private:
+    static constexpr int MAX_TAPS = PRE_FILTER_TAPS_PER_RATIO * PRE_FILTER_MAX_DECIMATION;
+
+    uint32_t input_rate_hz_ = SENSOR_SAMPLE_RATE_HZ;
+    int decimation_ = 1;
+    bool highpass_enabled_ = false;
+    float biquad_coeffs_[5] = {};
+    float biquad_state_[DSP_AXES][2] = {};
+    int taps_ = 0;
+    alignas(16) float fir_coeffs_[MAX_TAPS] = {};
+    alignas(16) float fir_delay_[DSP_AXES][MAX_TAPS] = {};
+    fir_f32_t fir_[DSP_AXES] = {};
+    alignas(16) float highpassed_[DSP_BLOCK_SAMPLES]; // 高通输出，作为 FIR 的输入
+    alignas(16) float output_[DSP_AXES][DSP_BLOCK_SAMPLES];
+
+    void designLowpass(int taps, float cutoff); // cutoff 为归一化频率 (相对输入采样率)
+};
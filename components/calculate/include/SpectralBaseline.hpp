@@ -0,0 +1,72 @@
+#pragma once
+#include "APPConfig.h"
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// 每个通道、每个频点的功率谱基线：在分贝域里用 Welford 递推均值与方差
+// 内存中均值与方差都用 float 递推：计数饱和后每帧只更新差值的 1/BASELINE_MAX_COUNT，量化后递推会卡在死区里
+// 只有写入文件时才量化，均值存为 int16 (1/128 dB)，方差存为 uint16 (1/256 dB^2)，文件中一个频点 4 字节
+// 计数达到 BASELINE_MAX_COUNT 后不再增长，之后相当于指数遗忘，可以跟踪设备缓慢的正常漂移
+// 存储按最大点数分配在工作内存里；每种 FFT 点数各存一个文件，切换回来时还能用原来学到的基线
+class SpectralBaseline {
+public:
+    static constexpr int CHANNELS = DSP_AXES + 1;
+    static constexpr int MAX_BINS = DSP_FFT_MAX_SAMPLES / 2;
+
+    SpectralBaseline() { };
+    ~SpectralBaseline();
+
+    // 设置频点数并清空基线，第一次调用时分配存储
+    esp_err_t setBins(int bins);
+    void reset();
+    bool isReady() const { return count_ >= BASELINE_LEARN_FRAMES; }
+    uint32_t getCount() const { return count_; }
+
+    // 相对基线的异常分数：各频点 z 值的均方根，即对角协方差下的马氏距离除以 sqrt(bins)
+    // 均方根对只出现在少数频点上的异常不敏感，peak_z 另外给出升高最多的单个频点的 z 值
+    float score(int channel, const float* psd, float* peak_z) const;
+    // 把一个通道的谱并入基线，所有通道更新完后调用 commitFrame()
+    void update(int channel, const float* psd);
+    void commitFrame();
+
+    // 存取 LittleFS，文件头与当前配置不一致时视为没有基线
+    esp_err_t save(uint32_t sample_rate_hz) const;
+    esp_err_t load(uint32_t sample_rate_hz);
+
+private:
+    static constexpr auto FILE_PATH_FORMAT = "/storage/baseline_%d.bin"; // 按频点数区分
+    static constexpr uint32_t FILE_MAGIC = 0x4C534242; // "BBSL"
+    static constexpr uint16_t FILE_VERSION = 1;
+    static constexpr float MEAN_SCALE = 128.0f;
+    static constexpr float VAR_SCALE = 256.0f;
+    static constexpr float VAR_FLOOR = 0.25f; // 方差下限 (dB^2)，避免几乎不变的频点 z 值失真
+    static constexpr float PSD_FLOOR = 1e-12f; // 约 -120 dB
+
+    struct FileHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t channels;
+        uint16_t bins;
+        uint16_t reserved;
+        uint32_t sample_rate_hz;
+        uint32_t count;
+    };
+
+    struct Bin {
+        float mean; // dB
+        float var; // dB^2
+    };
+    struct StoredBin {
+        int16_t mean;
+        uint16_t var;
+    };
+    Bin* bins_[CHANNELS] = {}; // 各通道 MAX_BINS 个，只用前 bin_count_ 个
+    int bin_count_ = 0;
+    uint32_t count_ = 0;
+
+    static float toDb(float psd);
+    static StoredBin quantize(const Bin& bin);
+    static Bin dequantize(const StoredBin& stored);
+    void filePath(char* path, size_t size) const;
+};
@@ -0,0 +1,55 @@
+#pragma once
+#include <stdint.h>
+
+#define SPECTRAL_TOP_K 4 // 上报的峰值个数
+#define SPECTRAL_MAX_BANDS 4 // 频带能量个数上限
+#define SPECTRAL_AXIS_VECTOR 3 // axis 取值：0/1/2 为 X/Y/Z，3 为三轴矢量合成
+
+// 每帧上报的紧凑特征记录，代替完整频谱上传
+struct SpectralFeatures {
+    int64_t timestamp_us; // 生成该记录的时刻
+    int axis; // 该记录对应的轴，见 SPECTRAL_AXIS_VECTOR
+    float dominant_freq_hz; // 主频，抛物线插值到亚频点
+    float dominant_psd;
+    struct Peak {
+        float freq_hz;
+        float psd;
+    } peaks[SPECTRAL_TOP_K]; // 按幅值从大到小，不足时 psd 为 0
+    float band_energy[SPECTRAL_MAX_BANDS]; // 各频带均方值 (psd * df 求和)
+    float rms; // 去均值后的时域有效值
+    float crest_factor; // 峰值 / 有效值
+    float centroid_hz; // 频谱质心
+    float kurtosis; // 时域峭度，正弦约 1.5，高斯约 3，冲击越多越大
+    float anomaly_score; // 相对学习到的基线的异常分数，基线未学完时为 0
+    float anomaly_peak_z; // 升高最多的单个频点的 z 值
+    Peak envelope_peaks[SPECTRAL_TOP_K]; // 最近一次包络谱的峰值（轴承故障特征频率），未启用包络分析时为 0
+};
+
+struct FeatureBand {
+    float low_hz;
+    float high_hz;
+};
+
+class SpectralFeatureExtractor {
+public:
+    SpectralFeatureExtractor() { };
+    ~SpectralFeatureExtractor() { };
+
+    void setBands(const FeatureBand* bands, int count);
+    void setDefaultBands(uint32_t sample_rate_hz); // 未配置时把 0 ~ fs/2 等分
+    int getBandCount() const { return band_count_; }
+
+    // psd 为单边功率谱密度 (bins 个点)，samples 为对应的时域样本（顺序无关）
+    void extract(const float* psd, int bins, uint32_t sample_rate_hz,
+        const float* samples, int length, SpectralFeatures* features);
+
+    // 前 K 个局部峰值，跳过 DC，按幅值从大到小并插值到亚频点；df 为频点间隔
+    static void findPeaks(const float* psd, int bins, float df, SpectralFeatures::Peak* peaks);
+
+private:
+    FeatureBand bands_[SPECTRAL_MAX_BANDS] = {};
+    int band_count_ = 0;
+
+    static float interpolatePeak(const float* psd, int bins, int k, float* peak_psd);
+    void extractTimeDomain(const float* samples, int length, SpectralFeatures* features);
+};
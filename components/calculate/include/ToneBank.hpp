@@ -0,0 +1,67 @@
+#pragma once
+#include <stdint.h>
+
+#define TONE_BANK_MAX_TONES 8 // 同时监测的频率个数上限
+
+// 需要持续监测的已知频率，例如转频、叶片通过频率、轴承特征频率
+struct ToneSpec {
+    float freq_hz;
+    float threshold; // 幅值阈值 (峰值，m/s^2)，<= 0 表示只监测不触发
+    int axis; // 监测的加速度轴 0/1/2
+};
+
+// 滑动 DFT 滤波器组：每个样本对每个频率做一次 O(1) 递推，始终保持最近 window 个样本上的 DFT 值
+// S[n] = x[n] + r*e^(-jw) * S[n-1] - r^window * e^(-jw*window) * x[n-window]
+// 频率不必落在 FFT 频点上；r 略小于 1，抑制浮点误差累积导致的漂移
+// 等效矩形窗，频率偏离 fs/window 整数倍时幅值有扇贝损失，最坏约 -3.9dB，阈值应留出余量
+class ToneBank {
+public:
+    ToneBank() { };
+    ~ToneBank() { };
+
+    void configure(const ToneSpec* tones, int count, uint32_t sample_rate_hz, int window);
+    int getToneCount() const { return tone_count_; }
+    const ToneSpec& getTone(int i) const { return tones_[i]; }
+
+    // 推入某一轴的一段新样本，old_samples 为对应的 window 个样本之前的旧样本，scale 把样本换算为物理量
+    template <typename T>
+    void update(int axis, const T* new_samples, const T* old_samples, int count, float scale)
+    {
+        for (int t = 0; t < tone_count_; t++) {
+            if (tones_[t].axis != axis) {
+                continue;
+            }
+            State& st = state_[t];
+            float s_re = st.s_re;
+            float s_im = st.s_im;
+            for (int i = 0; i < count; i++) {
+                const float x_new = new_samples[i] * scale;
+                const float x_old = old_samples[i] * scale;
+                const float re = x_new + st.c_re * s_re - st.c_im * s_im - st.d_re * x_old;
+                const float im = st.c_re * s_im + st.c_im * s_re - st.d_im * x_old;
+                s_re = re;
+                s_im = im;
+            }
+            st.s_re = s_re;
+            st.s_im = s_im;
+        }
+    }
+
+    float getAmplitude(int i) const; // 正弦峰值幅值估计 2|S|/window
+    int findTriggered() const; // 返回第一个超过阈值的频率序号，没有则返回 -1
+    bool hasTriggers() const; // 是否至少有一个频率设置了阈值
+    void reset();
+
+private:
+    struct State {
+        float c_re, c_im; // r*e^(-jw)
+        float d_re, d_im; // r^window * e^(-jw*window)
+        float s_re, s_im;
+    };
+    static constexpr float DAMPING = 0.99999f;
+
+    ToneSpec tones_[TONE_BANK_MAX_TONES] = {};
+    State state_[TONE_BANK_MAX_TONES] = {};
+    int tone_count_ = 0;
+    float amplitude_scale_ = 0; // 2 / window
+};
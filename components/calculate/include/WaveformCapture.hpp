@@ -0,0 +1,185 @@
+#pragma once
+#include "APPConfig.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include <atomic>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define CAPTURE_MAGIC 0x50414357 // "WCAP"
+#define CAPTURE_VERSION 1
+
+// 一次捕获的上传格式：头部之后紧跟 int16 原始计数，按轴连续存放 [axes][pre + post]
+struct __attribute__((packed)) CaptureHeader {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t axes;
+    uint8_t trigger; // WaveformCapture::capture_trigger_t
+    uint8_t trigger_axis;
+    uint32_t sequence;
+    uint32_t sample_rate_hz;
+    uint16_t pre_samples;
+    uint16_t post_samples;
+    int64_t trigger_time_us; // 触发所在块被处理的时刻，精度为一个采集块
+    float scale; // 每个计数对应的 m/s^2
+};
+
+// 触发波形捕获：与 DSP 共用同一个样本流，始终保留最近 pre 个样本，触发后再记录 post 个样本，冻结到一个捕获槽
+// 只在 DSP 任务里逐块处理，不会阻塞采集任务；槽写满后通过队列交给上传任务，上传完归还
+// 样本存为 int16 原始计数，开启 PSRAM 时缓冲区放在 PSRAM
+class WaveformCapture {
+public:
+    enum capture_trigger_t {
+        TRIGGER_NONE = 0,
+        TRIGGER_THRESHOLD = 1, // 偏离均值超过阈值
+        TRIGGER_SLOPE = 2, // 相邻样本之差超过阈值
+        TRIGGER_RMS_JUMP = 3, // 一块的 RMS 超过长期 RMS 的若干倍
+        TRIGGER_SPECTRAL = 4, // 频谱异常（由 DSP 引擎请求）
+        TRIGGER_MANUAL = 5,
+    };
+    struct TriggerConfig {
+        float threshold_msq; // <= 0 关闭
+        float slope_msq; // <= 0 关闭
+        float rms_jump_ratio; // <= 0 关闭
+        bool on_spectral_anomaly;
+    };
+
+    WaveformCapture() { };
+    ~WaveformCapture();
+
+    esp_err_t init(uint32_t sample_rate_hz, float scale);
+    void setTriggerConfig(const TriggerConfig& config) { config_ = config; }
+    const TriggerConfig& getTriggerConfig() const { return config_; }
+
+    // 外部请求一次捕获（任意任务可调用），在下一块开始处生效
+    void trigger(capture_trigger_t type, int axis = 0);
+
+    // DSP 任务：处理一块按结构数组排列的样本，各轴 count 个，轴间隔 stride
+    template <typename T>
+    void feed(const T* block, int count, int stride);
+
+    // 上传任务：从队列取得写满的槽号，读出数据，上传后归还
+    QueueHandle_t getReadyQueue() { return ready_queue_; }
+    const uint8_t* getSlotData(int slot, size_t* size) const;
+    void releaseSlot(int slot);
+    uint32_t getDroppedTriggers() const { return dropped_triggers_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr auto TAG = "WaveformCapture";
+    static constexpr int PRE = CAPTURE_PRE_SAMPLES;
+    static constexpr int POST = CAPTURE_POST_SAMPLES;
+    static constexpr int SLOTS = CAPTURE_SLOTS;
+    static constexpr float MEAN_ALPHA = 1.0f / 1024; // 均值与长期 RMS 的指数平均权重 (每样本)
+    static constexpr int RMS_WARMUP_BLOCKS = 16; // 长期 RMS 稳定之前不做 RMS 跳变判断
+    static constexpr size_t SLOT_BYTES = sizeof(CaptureHeader) + (size_t)DSP_AXES * (PRE + POST) * sizeof(int16_t);
+
+    enum slot_state_t {
+        SLOT_FREE = 0,
+        SLOT_FILLING = 1,
+        SLOT_READY = 2, // 已交给上传任务
+    };
+
+    TriggerConfig config_ = { CAPTURE_THRESHOLD_MSQ, CAPTURE_SLOPE_MSQ, CAPTURE_RMS_JUMP_RATIO, CAPTURE_ON_ANOMALY != 0 };
+    uint32_t sample_rate_hz_ = 0;
+    float scale_ = 1.0f;
+    int16_t* ring_ = nullptr; // [axes][PRE]
+    int ring_pos_ = 0;
+    uint8_t* slots_ = nullptr; // SLOTS 个槽，每个 SLOT_BYTES
+    std::atomic<int> slot_state_[SLOTS];
+    QueueHandle_t ready_queue_ = nullptr;
+    int filling_slot_ = -1;
+    int post_pos_ = 0;
+    uint32_t sequence_ = 0;
+    std::atomic<int> pending_trigger_ { TRIGGER_NONE };
+    std::atomic<int> pending_axis_ { 0 };
+    std::atomic<uint32_t> dropped_triggers_ { 0 };
+    float mean_[DSP_AXES] = {};
+    float mean_square_[DSP_AXES] = {}; // 长期均方值（去均值）
+    int16_t last_[DSP_AXES] = {};
+    bool primed_ = false; // 均值已初始化
+    int rms_blocks_ = 0;
+
+    static int16_t toCounts(int16_t value, float) { return value; }
+    static int16_t toCounts(float value, float inv_scale) { return (int16_t)lrintf(fminf(fmaxf(value * inv_scale, -32768.0f), 32767.0f)); }
+
+    CaptureHeader* slotHeader(int slot) const { return reinterpret_cast<CaptureHeader*>(slots_ + slot * SLOT_BYTES); }
+    int16_t* slotSamples(int slot, int axis) const
+    {
+        return reinterpret_cast<int16_t*>(slots_ + slot * SLOT_BYTES + sizeof(CaptureHeader)) + axis * (PRE + POST);
+    }
+    void startCapture(capture_trigger_t type, int axis);
+    void pushSample(const int16_t* sample);
+    capture_trigger_t checkSample(const int16_t* sample, int* axis) const;
+    capture_trigger_t checkBlockRms(const float* block_mean_square, int* axis) const;
+};
+
+template <typename T>
+void WaveformCapture::feed(const T* block, int count, int stride)
+{
+    if (ring_ == nullptr) {
+        return;
+    }
+    const float inv_scale = 1.0f / scale_;
+
+    // 块级触发：外部请求与 RMS 跳变都在块首生效，块首之前的样本作为触发前历史
+    capture_trigger_t block_trigger = static_cast<capture_trigger_t>(pending_trigger_.exchange(TRIGGER_NONE));
+    int block_axis = pending_axis_.load();
+    float block_mean_square[DSP_AXES] = {};
+    for (int axis = 0; axis < DSP_AXES; axis++) {
+        for (int i = 0; i < count; i++) {
+            const float d = toCounts(block[axis * stride + i], inv_scale) - mean_[axis];
+            block_mean_square[axis] += d * d;
+        }
+        block_mean_square[axis] /= count;
+    }
+    if (block_trigger == TRIGGER_NONE && rms_blocks_ >= RMS_WARMUP_BLOCKS) {
+        block_trigger = checkBlockRms(block_mean_square, &block_axis);
+    }
+
+    for (int i = 0; i < count; i++) {
+        int16_t sample[DSP_AXES];
+        for (int axis = 0; axis < DSP_AXES; axis++) {
+            sample[axis] = toCounts(block[axis * stride + i], inv_scale);
+        }
+        if (!primed_) {
+            for (int axis = 0; axis < DSP_AXES; axis++) {
+                mean_[axis] = sample[axis];
+                last_[axis] = sample[axis];
+            }
+            primed_ = true;
+        }
+        if (filling_slot_ < 0) {
+            int axis = block_axis;
+            capture_trigger_t type = (i == 0) ? block_trigger : TRIGGER_NONE;
+            if (type == TRIGGER_NONE) {
+                type = checkSample(sample, &axis);
+            }
+            if (type != TRIGGER_NONE) {
+                startCapture(type, axis);
+            }
+        }
+        if (filling_slot_ >= 0) {
+            for (int axis = 0; axis < DSP_AXES; axis++) {
+                slotSamples(filling_slot_, axis)[PRE + post_pos_] = sample[axis];
+            }
+            if (++post_pos_ >= POST) {
+                slot_state_[filling_slot_].store(SLOT_READY, std::memory_order_release);
+                xQueueSend(ready_queue_, &filling_slot_, 0); // 队列深度等于槽数，不会满
+                filling_slot_ = -1;
+            }
+        }
+        pushSample(sample);
+    }
+
+    // 长期均方值按块做指数平均，第一块直接作为初值；冲击本身对长期值的影响很小
+    const float weight = (rms_blocks_ == 0) ? 1.0f : fminf(1.0f, MEAN_ALPHA * count);
+    for (int axis = 0; axis < DSP_AXES; axis++) {
+        mean_square_[axis] += weight * (block_mean_square[axis] - mean_square_[axis]);
+    }
+    if (rms_blocks_ < RMS_WARMUP_BLOCKS) {
+        rms_blocks_++;
+    }
+}
@@ -0,0 +1,121 @@
+#include "EulerEncoder.hpp"
+#include "JsonWriter.hpp"
+#include <string.h>
+
+// JSON 中的姿态记录：时间为 ms，角度直接由原始计数按整数运算格式化成度
+using EulerDegrees = JsonCounts<(int)BNO055_EULER_DIV_DEG>;
+struct EulerJson {
+    int64_t t;
+    EulerDegrees roll;
+    EulerDegrees pitch;
+    EulerDegrees yaw;
+};
+static constexpr auto EULER_SCHEMA = jsonSchema<EulerJson>(
+    jsonField("t", &EulerJson::t),
+    jsonField<2>("roll", &EulerJson::roll),
+    jsonField<2>("pitch", &EulerJson::pitch),
+    jsonField<2>("yaw", &EulerJson::yaw));
+
+int JsonEulerEncoder::format(const EulerRecord& record, char* out, int capacity)
+{
+    const EulerJson json = {
+        record.timestamp_us / 1000,
+        { record.euler.r },
+        { record.euler.p },
+        { record.euler.h },
+    };
+    return EULER_SCHEMA.serialize(json, out, capacity);
+}
+
+int PackedEulerEncoder::begin(uint8_t* out, int capacity)
+{
+    if (capacity < (int)sizeof(TelemetryBatchHeader)) {
+        return -1;
+    }
+    // 记录数与基准时刻在 end/第一条记录时回填
+    TelemetryBatchHeader header = {};
+    header.magic = TELEMETRY_MAGIC;
+    header.version = TELEMETRY_VERSION;
+    header.schema = TELEMETRY_SCHEMA_EULER_PACKED;
+    header.scale = Bno055Driver::EULER_SCALE_DEG;
+    memcpy(out, &header, sizeof(header));
+    first = true;
+    return sizeof(header);
+}
+
+int PackedEulerEncoder::encode(const EulerRecord& record, uint8_t* out, int capacity)
+{
+    if (capacity < (int)sizeof(PackedEulerSample)) {
+        return -1;
+    }
+    const int64_t ms = record.timestamp_us / 1000;
+    const int64_t dt = first ? 0 : ms - last_ms;
+    if (dt < 0 || dt > UINT16_MAX) {
+        return -1;
+    }
+    if (first) {
+        base_time_us = record.timestamp_us;
+        first = false;
+    }
+    last_ms = ms;
+    const PackedEulerSample sample = { (uint16_t)dt, record.euler.r, record.euler.p, record.euler.h };
+    memcpy(out, &sample, sizeof(sample));
+    return sizeof(sample);
+}
+
+int PackedEulerEncoder::end(uint8_t* batch, int, int records)
+{
+    TelemetryBatchHeader* header = reinterpret_cast<TelemetryBatchHeader*>(batch);
+    header->records = (uint16_t)records;
+    header->base_time_us = base_time_us;
+    return 0;
+}
+
+int DeltaEulerEncoder::begin(uint8_t* out, int capacity)
+{
+    if (capacity < (int)sizeof(TelemetryBatchHeader)) {
+        return -1;
+    }
+    TelemetryBatchHeader header = {};
+    header.magic = TELEMETRY_MAGIC;
+    header.version = TELEMETRY_VERSION;
+    header.schema = TELEMETRY_SCHEMA_EULER_DELTA;
+    header.scale = Bno055Driver::EULER_SCALE_DEG;
+    memcpy(out, &header, sizeof(header));
+    first = true;
+    return sizeof(header);
+}
+
+int DeltaEulerEncoder::encode(const EulerRecord& record, uint8_t* out, int capacity)
+{
+    // 在副本上编码，放不下时不改变状态
+    State next = state;
+    if (first) {
+        next = { record.timestamp_us / 1000, 0, {} };
+    }
+    const int64_t ms = record.timestamp_us / 1000;
+    const int64_t dt = ms - next.last_ms;
+    BitWriter writer(out, capacity);
+    writer.writeVarint(TelemetryCodec::zigzag(dt - next.last_dt_ms));
+    writer.writeVarint(TelemetryCodec::zigzag(delta(record.euler.r, next.last.r)));
+    writer.writeVarint(TelemetryCodec::zigzag(delta(record.euler.p, next.last.p)));
+    writer.writeVarint(TelemetryCodec::zigzag(delta(record.euler.h, next.last.h)));
+    const int len = writer.finish();
+    if (len < 0) {
+        return -1;
+    }
+    if (first) {
+        base_time_us = record.timestamp_us;
+        first = false;
+    }
+    state = { ms, dt, record.euler };
+    return len;
+}
+
+int DeltaEulerEncoder::end(uint8_t* batch, int, int records)
+{
+    TelemetryBatchHeader* header = reinterpret_cast<TelemetryBatchHeader*>(batch);
+    header->records = (uint16_t)records;
+    header->base_time_us = base_time_us;
+    return 0;
+}
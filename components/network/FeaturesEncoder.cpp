@@ -0,0 +1,93 @@
+#include "FeaturesEncoder.hpp"
+#include "JsonWriter.hpp"
+#include <string.h>
+
+// 峰值写成 [频率, psd]
+template <>
+struct JsonValue<SpectralFeatures::Peak> {
+    static constexpr int MAX_PRECISION = 0; // 两个分量的精度固定
+    static void write(JsonWriter& writer, const SpectralFeatures::Peak& peak, const JsonFormat&)
+    {
+        writer.put('[');
+        writer.putFixed(peak.freq_hz, 2);
+        writer.put(',');
+        writer.putScientific(peak.psd, 3);
+        writer.put(']');
+    }
+};
+
+static constexpr auto FEATURES_SCHEMA = jsonSchema<SpectralFeatures>(
+    jsonField("ts", &SpectralFeatures::timestamp_us),
+    jsonField("axis", &SpectralFeatures::axis),
+    jsonField<2>("f0", &SpectralFeatures::dominant_freq_hz),
+    jsonField<3, JsonFormat::SCIENTIFIC>("p0", &SpectralFeatures::dominant_psd),
+    jsonField<4>("rms", &SpectralFeatures::rms),
+    jsonField<2>("crest", &SpectralFeatures::crest_factor),
+    jsonField<2>("centroid", &SpectralFeatures::centroid_hz),
+    jsonField<2>("kurtosis", &SpectralFeatures::kurtosis),
+    jsonField<2>("score", &SpectralFeatures::anomaly_score),
+    jsonField<2>("peak_z", &SpectralFeatures::anomaly_peak_z),
+    jsonField("peaks", &SpectralFeatures::peaks),
+    jsonField<3, JsonFormat::SCIENTIFIC>("bands", &SpectralFeatures::band_energy),
+    jsonField("env", &SpectralFeatures::envelope_peaks));
+
+int JsonFeaturesEncoder::format(const SpectralFeatures& features, char* out, int capacity)
+{
+    return FEATURES_SCHEMA.serialize(features, out, capacity);
+}
+
+int XorFeaturesEncoder::begin(uint8_t* out, int capacity)
+{
+    if (capacity < (int)sizeof(TelemetryBatchHeader)) {
+        return -1;
+    }
+    TelemetryBatchHeader header = {};
+    header.magic = TELEMETRY_MAGIC;
+    header.version = TELEMETRY_VERSION;
+    header.schema = TELEMETRY_SCHEMA_FEATURES_XOR;
+    header.scale = 1.0f;
+    memcpy(out, &header, sizeof(header));
+    first = true;
+    return sizeof(header);
+}
+
+int XorFeaturesEncoder::encode(const SpectralFeatures& features, uint8_t* out, int capacity)
+{
+    if (features.axis < 0 || features.axis >= Layout::AXES) {
+        return -1;
+    }
+    if (first) {
+        Layout::resetAxes(axes, features.timestamp_us);
+    }
+    // 在副本上编码，放不下时不改变状态
+    Layout::AxisState next = axes[features.axis];
+    const int64_t dt = features.timestamp_us - next.last_ts;
+    float fields[Layout::FIELDS];
+    Layout::gatherFields(features, fields);
+    BitWriter writer(out, capacity);
+    writer.writeBits(features.axis, 2);
+    writer.writeVarint(TelemetryCodec::zigzag(dt - next.last_dt));
+    for (int i = 0; i < Layout::FIELDS; i++) {
+        next.fields[i].write(writer, fields[i]);
+    }
+    const int len = writer.finish();
+    if (len < 0) {
+        return -1;
+    }
+    if (first) {
+        base_time_us = features.timestamp_us;
+        first = false;
+    }
+    next.last_ts = features.timestamp_us;
+    next.last_dt = dt;
+    axes[features.axis] = next;
+    return len;
+}
+
+int XorFeaturesEncoder::end(uint8_t* batch, int, int records)
+{
+    TelemetryBatchHeader* header = reinterpret_cast<TelemetryBatchHeader*>(batch);
+    header->records = (uint16_t)records;
+    header->base_time_us = base_time_us;
+    return 0;
+}
@@ -41,7 +41,13 @@ void MQTTClient::init()
 
     client = esp_mqtt_client_init(&mqtt_cfg);
     /* The last argument may be used to pass data to the event handler, in this example mqtt_event_handler */
-    esp_mqtt_client_register_event(client, static_cast<esp_mqtt_event_id_t>(ESP_EVENT_ANY_ID), mqtt_event_handler, NULL);
+    esp_mqtt_client_register_event(client, static_cast<esp_mqtt_event_id_t>(ESP_EVENT_ANY_ID), mqtt_event_handler, this);
+}
+
+void MQTTClient::set_message_handler(const char* topic, message_handler_t handler)
+{
+    handler_topic = topic;
+    message_handler = std::move(handler);
 }
 
 void MQTTClient::mqtt_start()
@@ -54,10 +60,14 @@ void MQTTClient::mqtt_event_handler(void* handler_args, esp_event_base_t base, i
 {
     ESP_LOGD(TAG, "Event dispatched from event loop base=%s, event_id=%" PRIi32 "", base, event_id);
     esp_mqtt_event_handle_t event = static_cast<esp_mqtt_event_handle_t>(event_data);
+    MQTTClient* self = static_cast<MQTTClient*>(handler_args);
 
     switch ((esp_mqtt_event_id_t)event_id) {
     case MQTT_EVENT_CONNECTED:
         status = CONNECTED;
+        if (self->handler_topic != nullptr) {
+            esp_mqtt_client_subscribe(event->client, self->handler_topic, 1); // 会话不保留，每次连接都要重新订阅
+        }
         break;
     case MQTT_EVENT_DISCONNECTED:
         status = DISCONNECTED;
@@ -69,6 +79,12 @@ void MQTTClient::mqtt_event_handler(void* handler_args, esp_event_base_t base, i
         break;
     case MQTT_EVENT_UNSUBSCRIBED:
         break;
+    case MQTT_EVENT_DATA:
+        // 命令都很短，分片到达的长消息直接忽略
+        if (self->message_handler && event->current_data_offset == 0 && event->data_len == event->total_data_len) {
+            self->message_handler(event->topic, event->topic_len, event->data, event->data_len);
+        }
+        break;
     case MQTT_EVENT_ERROR:
         break;
     default:
@@ -81,6 +97,16 @@ void MQTTClient::publish(const char* topic, const char* payload)
     esp_mqtt_client_publish(client, topic, payload, 0, 1, 0);
 }
 
+int MQTTClient::publish(const char* topic, const void* data, int len, int qos)
+{
+    return esp_mqtt_client_publish(client, topic, static_cast<const char*>(data), len, qos, 0);
+}
+
+int MQTTClient::get_outbox_size()
+{
+    return esp_mqtt_client_get_outbox_size(client);
+}
+
 void MQTTClient::subscribe(const char* topic)
 {
     esp_mqtt_client_subscribe(client, topic, 0);
@@ -0,0 +1,125 @@
+#pragma once
+#include "MQTTClient.hpp"
+#include "SegmentLog.hpp"
+#include "TelemetryEncoder.hpp"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <memory>
+#include <stdint.h>
+
+// 一个主题的批量发送策略：攒够条数、字节数或第一条记录等待超过最长延迟时发出一批，以先到者为准
+struct BatchPolicy {
+    int max_records; // 1 即逐条发送
+    int max_bytes; // 一批负载的上限，含批头与批尾
+    int max_latency_ms;
+    int qos;
+};
+
+// 把多条记录合并成一个负载发出，每批只付一次主题开销、一次 outbox 分配和一次 PUBACK 往返
+// 负载格式由编码器决定 (JSON 数组或二进制)；未连接或发送失败时整批写入离线日志，重连后由 MQTT 任务补发
+// 只在 MQTT 任务中使用，不加锁
+template <typename Record>
+class BatchPublisher {
+public:
+    BatchPublisher(std::shared_ptr<MQTTClient> mqtt_client, const char* topic, const BatchPolicy& policy,
+        std::unique_ptr<TelemetryEncoder<Record>> encoder)
+        : mqtt_client(std::move(mqtt_client))
+        , topic(topic)
+        , policy(policy)
+        , encoder(std::move(encoder))
+        , payload(new uint8_t[policy.max_bytes]) { };
+    ~BatchPublisher() { };
+
+    void setSpool(std::shared_ptr<SegmentLog> spool) { this->spool = std::move(spool); }
+
+    // 追加一条记录，当前批次放不下时先发出再重试；单条记录就超过上限时丢弃并返回 false
+    bool add(const Record& record);
+    // 第一条记录等待超过最长延迟时发出
+    void poll(int64_t now_us);
+    void flush();
+
+    const char* getTopic() const { return topic; }
+    uint32_t getBatchesSent() const { return batches_sent; }
+    uint32_t getRecordsSent() const { return records_sent; }
+    uint32_t getBytesSent() const { return bytes_sent; }
+    uint32_t getBatchesSpooled() const { return batches_spooled; }
+    uint32_t getBatchesFailed() const { return batches_failed; }
+
+private:
+    static constexpr auto TAG = "BatchPublisher";
+    std::shared_ptr<MQTTClient> mqtt_client;
+    const char* topic;
+    BatchPolicy policy;
+    std::unique_ptr<TelemetryEncoder<Record>> encoder;
+    std::shared_ptr<SegmentLog> spool;
+    std::unique_ptr<uint8_t[]> payload;
+    int payload_len = 0;
+    int records = 0;
+    int64_t first_record_us = 0;
+    uint32_t batches_sent = 0;
+    uint32_t records_sent = 0;
+    uint32_t bytes_sent = 0;
+    uint32_t batches_spooled = 0;
+    uint32_t batches_failed = 0;
+};
+
+template <typename Record>
+bool BatchPublisher<Record>::add(const Record& record)
+{
+    const int capacity = policy.max_bytes - encoder->trailerSize();
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (records == 0) {
+            payload_len = encoder->begin(payload.get(), capacity);
+            if (payload_len < 0) {
+                payload_len = 0;
+                break;
+            }
+            first_record_us = esp_timer_get_time();
+        }
+        const int len = encoder->encode(record, payload.get() + payload_len, capacity - payload_len);
+        if (len >= 0) {
+            payload_len += len;
+            if (++records >= policy.max_records) {
+                flush();
+            }
+            return true;
+        }
+        if (records == 0) {
+            break; // 空批次也放不下
+        }
+        flush();
+    }
+    ESP_LOGW(TAG, "%s: record exceeds batch limit %d, dropped", topic, policy.max_bytes);
+    return false;
+}
+
+template <typename Record>
+void BatchPublisher<Record>::poll(int64_t now_us)
+{
+    if (records > 0 && now_us - first_record_us >= (int64_t)policy.max_latency_ms * 1000) {
+        flush();
+    }
+}
+
+template <typename Record>
+void BatchPublisher<Record>::flush()
+{
+    if (records == 0) {
+        return;
+    }
+    payload_len += encoder->end(payload.get(), payload_len, records);
+    // 未连接时不交给 esp-mqtt，否则 QoS1 消息会在内存里的 outbox 中无限堆积
+    if (mqtt_client->get_status() == MQTTClient::CONNECTED
+        && mqtt_client->publish(topic, payload.get(), payload_len, policy.qos) >= 0) {
+        batches_sent++;
+        records_sent += records;
+        bytes_sent += payload_len;
+    } else if (spool != nullptr && spool->append(topic, payload.get(), payload_len) == ESP_OK) {
+        batches_spooled++;
+    } else {
+        batches_failed++; // 没有离线日志或写入失败，这一批丢弃
+        ESP_LOGW(TAG, "%s: failed to publish %d records", topic, records);
+    }
+    payload_len = 0;
+    records = 0;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "MQTTClient.hpp"
+#include "Thread.hpp"
+#include "DSPEngine.hpp"
+#include "WaveformCapture.hpp"
+#include <memory>
+#include <string.h>
+
+// 一段捕获分成若干条 MQTT 消息上传，每条前面加分片头，接收端按 sequence 与 chunk 拼回完整的捕获
+struct __attribute__((packed)) CaptureChunkHeader {
+    uint32_t sequence; // 与 CaptureHeader::sequence 相同
+    uint16_t chunk;
+    uint16_t chunks;
+};
+
+// 捕获上传任务：优先级低于特征上报，写满的捕获槽在这里慢慢发出，不占用 DSP 与 MQTT 任务的时间
+class CaptureUploadTask : public Thread {
+public:
+    CaptureUploadTask(std::shared_ptr<MQTTClient> mqtt_client, std::shared_ptr<DSPEngine> dsp_engine)
+        : Thread("CaptureUploadTask", 1024 * 3, PRIO_CAPTURE_UPLOAD, 0)
+        , mqtt_client(std::move(mqtt_client))
+        , dsp_engine(std::move(dsp_engine)) { };
+    ~CaptureUploadTask() { };
+    void run() override
+    {
+        WaveformCapture& capture = dsp_engine->getCapture();
+        // 捕获在 DSP 任务启动后才分配，队列创建之前先等待
+        while (capture.getReadyQueue() == nullptr) {
+            vTaskDelay(pdMS_TO_TICKS(100));
+        }
+        while (1) {
+            int slot;
+            if (!xQueueReceive(capture.getReadyQueue(), &slot, portMAX_DELAY)) {
+                continue;
+            }
+            size_t size;
+            const uint8_t* data = capture.getSlotData(slot, &size);
+            upload(data, size);
+            capture.releaseSlot(slot);
+        }
+    };
+
+private:
+    static constexpr auto TAG = "CaptureUploadTask";
+    static constexpr size_t CHUNK_BYTES = 2048;
+    std::shared_ptr<MQTTClient> mqtt_client;
+    std::shared_ptr<DSPEngine> dsp_engine;
+    uint8_t chunk_buffer[sizeof(CaptureChunkHeader) + CHUNK_BYTES];
+
+    void upload(const uint8_t* data, size_t size)
+    {
+        CaptureChunkHeader header;
+        memcpy(&header.sequence, data + offsetof(CaptureHeader, sequence), sizeof(header.sequence));
+        header.chunks = (size + CHUNK_BYTES - 1) / CHUNK_BYTES;
+        for (header.chunk = 0; header.chunk < header.chunks; header.chunk++) {
+            const size_t offset = (size_t)header.chunk * CHUNK_BYTES;
+            const size_t len = (size - offset < CHUNK_BYTES) ? size - offset : CHUNK_BYTES;
+            memcpy(chunk_buffer, &header, sizeof(header));
+            memcpy(chunk_buffer + sizeof(header), data + offset, len);
+            // 断线时等待重连后重发当前分片，槽一直占用，新的触发会被丢弃并计数
+            while (mqtt_client->get_status() != MQTTClient::CONNECTED
+                || mqtt_client->publish("bno055/capture", chunk_buffer, sizeof(header) + len, 1) < 0) {
+                vTaskDelay(pdMS_TO_TICKS(500));
+            }
+        }
+        ESP_LOGI(TAG, "capture %" PRIu32 " uploaded, %u bytes in %u chunks, %" PRIu32 " triggers dropped",
+            header.sequence, (unsigned)size, (unsigned)header.chunks, dsp_engine->getCapture().getDroppedTriggers());
+    }
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include "TelemetryCodec.hpp"
+#include "TelemetryEncoder.hpp"
+#include "bno055driver.hpp"
+
+// {"t":ms,"roll":..,"pitch":..,"yaw":..}，单位为度
+class JsonEulerEncoder : public JsonArrayEncoder<EulerRecord> {
+protected:
+    int format(const EulerRecord& record, char* out, int capacity) override;
+};
+
+// 紧凑二进制格式：TelemetryBatchHeader 之后每条记录 8 字节 (PackedEulerSample)，约为 JSON 的七分之一
+// 时间差相对上一条记录，超过 uint16 范围 (约 65 s) 时另起一批；角度保留原始计数，不做浮点格式化
+class PackedEulerEncoder : public TelemetryEncoder<EulerRecord> {
+public:
+    int begin(uint8_t* out, int capacity) override;
+    int encode(const EulerRecord& record, uint8_t* out, int capacity) override;
+    int end(uint8_t* batch, int len, int records) override;
+
+private:
+    bool first = true;
+    int64_t base_time_us = 0;
+    int64_t last_ms = 0;
+};
+
+// 压缩格式：姿态变化缓慢、采样间隔固定，二阶时间差分和角度差分绝大多数落在一个字节内，每条记录通常 4 字节
+// 角度差分按 int16 回绕计算，航向从 359° 跳到 0° 时也只多占一个字节
+class DeltaEulerEncoder : public TelemetryEncoder<EulerRecord> {
+public:
+    int begin(uint8_t* out, int capacity) override;
+    int encode(const EulerRecord& record, uint8_t* out, int capacity) override;
+    int end(uint8_t* batch, int len, int records) override;
+
+private:
+    struct State {
+        int64_t last_ms;
+        int64_t last_dt_ms;
+        bno055_euler_t last;
+    };
+    bool first = true;
+    int64_t base_time_us = 0;
+    State state = {};
+
+    static int16_t delta(int16_t value, int16_t last) { return (int16_t)(uint16_t)(value - last); }
+};
@@ -0,0 +1,26 @@
+#pragma once
+#include "SpectralFeatures.hpp"
+#include "TelemetryCodec.hpp"
+#include "TelemetryDecoder.hpp"
+#include "TelemetryEncoder.hpp"
+
+// 频谱特征只在每个分析段产生一条，默认保持 JSON 便于直接接入云平台
+class JsonFeaturesEncoder : public JsonArrayEncoder<SpectralFeatures> {
+protected:
+    int format(const SpectralFeatures& features, char* out, int capacity) override;
+};
+
+// 压缩格式：同一轴相邻两段的特征变化很小，各浮点字段与该轴上一条记录异或后只写有效位
+// 时间戳按轴做二阶差分，分析步进固定时几乎总是 0；字段布局见 XorFeaturesLayout，解码见 TelemetryDecoder
+class XorFeaturesEncoder : public TelemetryEncoder<SpectralFeatures> {
+public:
+    int begin(uint8_t* out, int capacity) override;
+    int encode(const SpectralFeatures& features, uint8_t* out, int capacity) override;
+    int end(uint8_t* batch, int len, int records) override;
+
+private:
+    using Layout = XorFeaturesLayout;
+    bool first = true;
+    int64_t base_time_us = 0;
+    Layout::AxisState axes[Layout::AXES];
+};
@@ -0,0 +1,352 @@
+#pragma once
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <tuple>
+#include <type_traits>
+
+// 浮点字段的输出方式：定点小数 (%.Nf) 或科学计数 (%.Ne)
+struct JsonFormat {
+    enum notation_t {
+        FIXED = 0,
+        SCIENTIFIC = 1,
+    };
+    int precision;
+    notation_t notation;
+};
+
+// 定点计数值 counts / DIV，例如 BNO055 欧拉角 (16 LSB/度)；按 32 位整数格式化，不经过浮点
+template <int DIV>
+struct JsonCounts {
+    int16_t counts;
+};
+
+// 直接写进调用者提供的缓冲区，不分配内存；ESP32-S3 只有单精度 FPU，这里只用 float 与 32 位整数运算，不经过 snprintf
+// 输出与 printf 的 %.Nf / %.Ne 逐字一致，包括恰好一半时舍入到偶数与 "-0.00" 这样的负零，例外只有两处：
+// 定点小数超过 2^23 个最小单位时改用科学计数；科学计数需要按超过 10^±10 缩放时末位可能差 1，见 scaleRound
+// 写满后只置溢出标志，finish 返回 -1；NaN 与无穷写成 null，保证输出始终是合法 JSON
+class JsonWriter {
+public:
+    // 尾数最多 MAX_PRECISION + 2 位，保证按单精度缩放后仍小于 2^23，整数部分与舍入都是精确的
+    static constexpr int MAX_PRECISION = 5;
+    // JsonCounts 的 |counts| * 10^precision 需在 int32 范围内
+    static constexpr int MAX_COUNTS_PRECISION = 4;
+
+    JsonWriter(char* out, int capacity)
+        : out(out)
+        , capacity(capacity) { };
+
+    void put(char c)
+    {
+        if (len < capacity) {
+            out[len++] = c;
+        } else {
+            overflow = true;
+        }
+    }
+    void put(const char* s, int n)
+    {
+        if (len + n <= capacity) {
+            memcpy(out + len, s, n);
+            len += n;
+        } else {
+            overflow = true;
+        }
+    }
+    void putKey(const char* name, int n)
+    {
+        put('"');
+        put(name, n);
+        put("\":", 2);
+    }
+    void putInt(int64_t value)
+    {
+        uint64_t magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+        if (value < 0) {
+            put('-');
+        }
+        // 超出 32 位的部分每次取低 4 位十进制，先取出的低位后输出
+        uint32_t groups[4];
+        int n = 0;
+        while (magnitude > UINT32_MAX) {
+            groups[n++] = divmod10000(&magnitude);
+        }
+        putDigits((uint32_t)magnitude, 1);
+        while (n > 0) {
+            putDigits(groups[--n], 4);
+        }
+    }
+    // counts / DIV 保留 decimals 位小数；除数是编译期常数，2 的幂时就是移位
+    template <int DIV>
+    void putCounts(int32_t counts, int decimals)
+    {
+        static_assert(DIV > 0, "JsonCounts divisor must be positive");
+        const int32_t scale = POW10I[decimals];
+        const int32_t scaled = (counts < 0 ? -counts : counts) * scale;
+        int32_t units = scaled / DIV;
+        const int32_t remainder = scaled % DIV;
+        if (remainder * 2 > DIV || (remainder * 2 == DIV && (units & 1))) {
+            units++;
+        }
+        if (counts < 0) {
+            put('-');
+        }
+        putUnits(units, decimals);
+    }
+    void putFixed(float value, int decimals)
+    {
+        if (!isfinite(value)) {
+            put("null", 4);
+            return;
+        }
+        const float magnitude = fabsf(value);
+        const float scale = POW10F[decimals];
+        const float scaled = magnitude * scale;
+        if (scaled >= UNITS_LIMIT) {
+            putScientific(value, decimals); // 超出精确舍入的范围，退回科学计数
+            return;
+        }
+        const int32_t units = roundHalfEven(scaled, fmaf(magnitude, scale, -scaled), 1.0f);
+        if (signbit(value)) {
+            put('-');
+        }
+        putUnits(units, decimals);
+    }
+    void putScientific(float value, int digits)
+    {
+        if (!isfinite(value)) {
+            put("null", 4);
+            return;
+        }
+        const float magnitude = fabsf(value);
+        int exponent = 0;
+        int32_t mantissa = 0;
+        const int32_t limit = POW10I[digits + 1];
+        if (magnitude > 0) {
+            exponent = decimalExponent(magnitude);
+            mantissa = scaleRound(magnitude, digits - exponent);
+            // 估计的指数可能小一，或舍入进位后尾数多一位
+            if (mantissa >= limit) {
+                exponent++;
+                mantissa = scaleRound(magnitude, digits - exponent);
+            } else if (mantissa < limit / 10) {
+                exponent--;
+                mantissa = scaleRound(magnitude, digits - exponent);
+            }
+        }
+        if (signbit(value)) {
+            put('-');
+        }
+        putUnits(mantissa, digits);
+        put('e');
+        put(exponent < 0 ? '-' : '+');
+        putDigits(exponent < 0 ? -exponent : exponent, 2);
+    }
+    void putFloat(float value, const JsonFormat& format)
+    {
+        if (format.notation == JsonFormat::SCIENTIFIC) {
+            putScientific(value, format.precision);
+        } else {
+            putFixed(value, format.precision);
+        }
+    }
+    int finish() const { return overflow ? -1 : len; }
+
+private:
+    static constexpr float UNITS_LIMIT = 8388608.0f; // 2^23，以下的 float 小数部分精度不低于 0.5
+    static constexpr int POW10_EXACT = 10; // 5^10 < 2^24，10^0 ~ 10^10 在单精度中都是精确的
+    static constexpr float POW10F[POW10_EXACT + 1] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+    static constexpr int32_t POW10I[MAX_PRECISION + 2] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+    char* out;
+    int capacity;
+    int len = 0;
+    bool overflow = false;
+
+    // q + r / p (p > 0) 按 printf 的规则舍入到整数，恰好一半时取偶数；要求 0 <= q < 2^23 且 |r / p| 不超过 q 的半个 ulp
+    // 乘积 a * b 取 q = a * b、r = fmaf(a, b, -q)、p = 1；商 a / b 取 q = a / b、r = fmaf(-q, b, a)、p = b，两种情况 r 都是精确的
+    // 小数部分不足 0.25 时加上 r / p 也到不了一半；否则 (fraction - 0.5) * p + r 与精确值减一半同号，
+    // 融合乘加只舍入一次，符号与是否为零都是准确的 (ESP32-S3 上是一条 madd.s)
+    static int32_t roundHalfEven(float q, float r, float p)
+    {
+        int32_t integer = (int32_t)q;
+        const float fraction = q - (float)integer; // 精确
+        if (fraction >= 0.25f) {
+            const float diff = fmaf(fraction - 0.5f, p, r);
+            if (diff > 0 || (diff == 0 && (integer & 1))) {
+                integer++;
+            }
+        }
+        return integer;
+    }
+    // magnitude * 10^exponent 舍入到整数；|exponent| <= 10 时 10 的幂是精确的，结果与 printf 一致
+    // 超出时先按 1e10 逐级缩放，每级约 2^-24 的相对误差，离一半极近的值末位可能与 printf 差 1
+    static int32_t scaleRound(float magnitude, int exponent)
+    {
+        while (exponent > POW10_EXACT) {
+            magnitude *= POW10F[POW10_EXACT];
+            exponent -= POW10_EXACT;
+        }
+        while (exponent < -POW10_EXACT) {
+            magnitude /= POW10F[POW10_EXACT];
+            exponent += POW10_EXACT;
+        }
+        if (exponent >= 0) {
+            const float scale = POW10F[exponent];
+            const float scaled = magnitude * scale;
+            return roundHalfEven(scaled, fmaf(magnitude, scale, -scaled), 1.0f);
+        }
+        const float scale = POW10F[-exponent];
+        const float quotient = magnitude / scale;
+        return roundHalfEven(quotient, fmaf(-quotient, scale, magnitude), scale);
+    }
+    // floor(log10(magnitude)) 的估计，可能小一；由二进制指数乘 log10(2) ≈ 1233 / 4096 得到，不调用 log10
+    static int decimalExponent(float magnitude)
+    {
+        uint32_t bits;
+        memcpy(&bits, &magnitude, sizeof(bits));
+        const int biased = (int)(bits >> 23);
+        const int binary = biased != 0 ? biased - 127 : (31 - __builtin_clz(bits)) - 149; // 非规格化数按最高有效位计
+        return (binary * 1233) >> 12;
+    }
+    // 64 位整数按 16 位分段做长除法，取出最低的 4 位十进制，只用 32 位除法
+    static uint32_t divmod10000(uint64_t* value)
+    {
+        uint64_t quotient = 0;
+        uint32_t remainder = 0;
+        for (int shift = 48; shift >= 0; shift -= 16) {
+            const uint32_t part = (remainder << 16) | (uint32_t)((*value >> shift) & 0xFFFF);
+            quotient = (quotient << 16) | (part / 10000);
+            remainder = part % 10000;
+        }
+        *value = quotient;
+        return remainder;
+    }
+    // units 个 10^-decimals：整数部分与补零的小数部分
+    void putUnits(int32_t units, int decimals)
+    {
+        const int32_t scale = POW10I[decimals];
+        putDigits(units / scale, 1);
+        if (decimals > 0) {
+            put('.');
+            putDigits(units % scale, decimals);
+        }
+    }
+    // 至少 min_digits 位，不足补零
+    void putDigits(uint32_t value, int min_digits)
+    {
+        char digits[10];
+        int n = 0;
+        do {
+            digits[n++] = (char)('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        while (n < min_digits) {
+            digits[n++] = '0';
+        }
+        if (len + n > capacity) {
+            overflow = true;
+            return;
+        }
+        for (int i = n - 1; i >= 0; i--) {
+            out[len++] = digits[i];
+        }
+    }
+};
+
+// 字段值的写法按类型在编译期选择；结构体元素需要特化 JsonValue，并给出该类型允许的最大精度
+template <typename V, typename Enable = void>
+struct JsonValue;
+
+template <typename V>
+struct JsonValue<V, typename std::enable_if<std::is_integral<V>::value>::type> {
+    static constexpr int MAX_PRECISION = 0;
+    static void write(JsonWriter& writer, V value, const JsonFormat&) { writer.putInt(value); }
+};
+
+template <>
+struct JsonValue<float> {
+    static constexpr int MAX_PRECISION = JsonWriter::MAX_PRECISION;
+    static void write(JsonWriter& writer, float value, const JsonFormat& format) { writer.putFloat(value, format); }
+};
+
+template <int DIV>
+struct JsonValue<JsonCounts<DIV>> {
+    static constexpr int MAX_PRECISION = JsonWriter::MAX_COUNTS_PRECISION;
+    static void write(JsonWriter& writer, const JsonCounts<DIV>& value, const JsonFormat& format)
+    {
+        writer.putCounts<DIV>(value.counts, format.precision);
+    }
+};
+
+template <typename E, size_t N>
+struct JsonValue<E[N]> {
+    static constexpr int MAX_PRECISION = JsonValue<E>::MAX_PRECISION;
+    static void write(JsonWriter& writer, const E (&values)[N], const JsonFormat& format)
+    {
+        writer.put('[');
+        for (size_t i = 0; i < N; i++) {
+            if (i > 0) {
+                writer.put(',');
+            }
+            JsonValue<E>::write(writer, values[i], format);
+        }
+        writer.put(']');
+    }
+};
+
+// 一个字段：名字在编译期确定长度，按成员指针取值
+template <typename T, typename M>
+struct JsonField {
+    const char* name;
+    int name_len;
+    M T::*member;
+    JsonFormat format;
+};
+
+// 精度与记法是模板参数，超出字段类型允许的精度在编译期报错：jsonField<2>("roll", &EulerJson::roll)
+template <int PRECISION = 0, JsonFormat::notation_t NOTATION = JsonFormat::FIXED, typename T, typename M, size_t N>
+constexpr JsonField<T, M> jsonField(const char (&name)[N], M T::*member)
+{
+    static_assert(PRECISION >= 0 && PRECISION <= JsonValue<M>::MAX_PRECISION, "JSON field precision out of range for its type");
+    return { name, (int)N - 1, member, { PRECISION, NOTATION } };
+}
+
+// 结构体的 JSON 描述：字段顺序即输出顺序，序列化时逐字段展开，没有运行时查表
+template <typename T, typename... Fields>
+class JsonSchema {
+public:
+    constexpr JsonSchema(Fields... fields)
+        : fields(fields...) { };
+
+    // 返回写入的字节数 (不含结尾 '\0')，放不下返回 -1
+    int serialize(const T& value, char* out, int capacity) const
+    {
+        JsonWriter writer(out, capacity);
+        writer.put('{');
+        bool first = true;
+        std::apply([&](const auto&... field) { (writeField(writer, value, field, first), ...); }, fields);
+        writer.put('}');
+        return writer.finish();
+    }
+
+private:
+    std::tuple<Fields...> fields;
+
+    template <typename M>
+    static void writeField(JsonWriter& writer, const T& value, const JsonField<T, M>& field, bool& first)
+    {
+        if (!first) {
+            writer.put(',');
+        }
+        first = false;
+        writer.putKey(field.name, field.name_len);
+        JsonValue<M>::write(writer, value.*field.member, field.format);
+    }
+};
+
+template <typename T, typename... Fields>
+constexpr JsonSchema<T, Fields...> jsonSchema(Fields... fields)
+{
+    return JsonSchema<T, Fields...>(fields...);
+}
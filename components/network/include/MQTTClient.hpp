@@ -9,13 +9,20 @@
 #include "led.hpp"
 #include "nvs_flash.h"
 #include "mqtt_client.h"
+#include <functional>
 
 class MQTTClient {
 public:
     MQTTClient() { };
     ~MQTTClient() { };
     void init();
+    // 订阅主题上收到的完整消息，在 MQTT 客户端任务中回调
+    using message_handler_t = std::function<void(const char* topic, int topic_len, const char* data, int data_len)>;
+    // 需在 init() 之前设置，每次连接成功后自动订阅 topic
+    void set_message_handler(const char* topic, message_handler_t handler);
     void publish(const char* topic, const char* payload);
+    int publish(const char* topic, const void* data, int len, int qos); // 二进制负载，返回消息 ID，失败返回 -1
+    int get_outbox_size(); // 等待发送或确认的消息占用的字节数
     void subscribe(const char* topic);
     void unsubscribe(const char* topic);
     void mqtt_start();
@@ -34,6 +41,8 @@ private:
     static mqtt_status_t status;
     static constexpr auto TAG = "MQTTClient";
     esp_mqtt_client_handle_t client;
+    const char* handler_topic = nullptr;
+    message_handler_t message_handler;
     static void mqtt_event_handler(void* handler_args, esp_event_base_t base, int32_t event_id, void* event_data);
     static void log_error_if_nonzero(const char* message, int error_code);
 };
@@ -1,31 +1,77 @@
 #include "MQTTClient.hpp"
+#include "BatchPublisher.hpp"
+#include "EulerEncoder.hpp"
+#include "FeaturesEncoder.hpp"
 #include "Thread.hpp"
 #include "bno055driver.hpp"
+#include "DSPEngine.hpp"
+#include "SegmentLog.hpp"
+#include "cJSON.h"
+#include "esp_timer.h"
 #include <memory>
 
 class MQTTTask : public Thread {
 public:
-    MQTTTask(std::shared_ptr<MQTTClient> mqtt_client, std::shared_ptr<Bno055Driver> bno055)
+    MQTTTask(std::shared_ptr<MQTTClient> mqtt_client, std::shared_ptr<Bno055Driver> bno055, std::shared_ptr<DSPEngine> dsp_engine,
+        std::shared_ptr<SegmentLog> spool)
         : Thread("MQTTTask", 1024 * 5, PRIO_MQTT, 0)
         , mqtt_client(std::move(mqtt_client))
-        , bno055(std::move(bno055)) { };
+        , bno055(std::move(bno055))
+        , dsp_engine(std::move(dsp_engine))
+        , spool(std::move(spool))
+#if MQTT_EULER_ENCODING == 2
+        , euler_batch(this->mqtt_client, "bno055/euler/packed",
+              { MQTT_BATCH_EULER_RECORDS, MQTT_BATCH_EULER_BYTES, MQTT_BATCH_EULER_LATENCY_MS, 1 },
+              std::make_unique<DeltaEulerEncoder>())
+#elif MQTT_EULER_ENCODING == 1
+        , euler_batch(this->mqtt_client, "bno055/euler/packed",
+              { MQTT_BATCH_EULER_RECORDS, MQTT_BATCH_EULER_BYTES, MQTT_BATCH_EULER_LATENCY_MS, 1 },
+              std::make_unique<PackedEulerEncoder>())
+#else
+        , euler_batch(this->mqtt_client, "bno055/euler",
+              { MQTT_BATCH_EULER_RECORDS, MQTT_BATCH_EULER_BYTES, MQTT_BATCH_EULER_LATENCY_MS, 1 },
+              std::make_unique<JsonEulerEncoder>())
+#endif
+#if MQTT_FEATURES_COMPRESSED
+        , features_batch(this->mqtt_client, "bno055/features/packed",
+              { MQTT_BATCH_FEATURES_RECORDS, MQTT_BATCH_FEATURES_BYTES, MQTT_BATCH_FEATURES_LATENCY_MS, 1 },
+              std::make_unique<XorFeaturesEncoder>())
+#else
+        , features_batch(this->mqtt_client, "bno055/features",
+              { MQTT_BATCH_FEATURES_RECORDS, MQTT_BATCH_FEATURES_BYTES, MQTT_BATCH_FEATURES_LATENCY_MS, 1 },
+              std::make_unique<JsonFeaturesEncoder>())
+#endif
+    {
+        euler_batch.setSpool(this->spool);
+        features_batch.setSpool(this->spool);
+    };
     ~MQTTTask() { };
     void run() override
     {
+        mqtt_client->set_message_handler(MQTT_COMMAND_TOPIC, [this](const char*, int, const char* data, int len) {
+            handle_command(data, len);
+        });
         mqtt_client->init();
+        // 断网时也照常取走队列里的数据，批次由 BatchPublisher 写入离线日志，采集任务不会因队列满而阻塞
         while (1) {
+            EulerRecord record;
+            // 振动模式下没有姿态数据，不能一直阻塞在姿态队列上；这 10ms 的等待也让出了 CPU
+            // 记录自带采样时刻，合并成一批发送后接收端据此还原时间轴
+            if (bno055->get_euler_channel().pop(&record, pdMS_TO_TICKS(10))) {
+                euler_batch.add(record);
+            }
+            SpectralFeatures features;
+            if (dsp_engine->getFeaturesChannel().pop(&features, 0)) {
+                features_batch.add(features);
+            }
+            const int64_t now_us = esp_timer_get_time();
+            euler_batch.poll(now_us);
+            features_batch.poll(now_us);
             if (mqtt_client->get_status() == MQTTClient::CONNECTED) {
-                bno055_euler_double_t euler;
-                if (xQueueReceive(bno055->get_euler_queue_handle(), &euler, portMAX_DELAY)) {
-                    // TODO: 后面改成json格式
-                    char euler_str[128];
-                    snprintf(euler_str, sizeof(euler_str), "{\"roll\":%.2f,\"pitch\":%.2f,\"yaw\":%.2f}", euler.r, euler.p, euler.h);
-                    mqtt_client->publish("bno055/euler", euler_str);
-                }
-                ESP_LOGI(TAG, "MQTTTask stack high water mark: %d", uxTaskGetStackHighWaterMark(NULL));
-            } else {
-                vTaskDelay(pdMS_TO_TICKS(10));  //未连接的时候不能一直占着cpu
+                replay_spool(now_us);
             }
+            log_channel_stats(now_us);
+            ESP_LOGD(TAG, "MQTTTask stack high water mark: %d", uxTaskGetStackHighWaterMark(NULL));
         }
     };
 
@@ -41,6 +87,83 @@ private:
     static constexpr auto TAG = "MQTTTask";
     std::shared_ptr<MQTTClient> mqtt_client;
     std::shared_ptr<Bno055Driver> bno055;
+    std::shared_ptr<DSPEngine> dsp_engine;
+    std::shared_ptr<SegmentLog> spool;
+    BatchPublisher<EulerRecord> euler_batch;
+    BatchPublisher<SpectralFeatures> features_batch; // 上传频谱特征而不是整段频谱
+    static constexpr int REPLAY_BUFFER_BYTES = MQTT_BATCH_EULER_BYTES > MQTT_BATCH_FEATURES_BYTES ? MQTT_BATCH_EULER_BYTES : MQTT_BATCH_FEATURES_BYTES;
+    std::unique_ptr<uint8_t[]> replay_buffer;
+    int64_t next_replay_us = 0;
+
+    int64_t next_stats_us = 0;
+    uint32_t last_dropped = 0;
+
+    // 只在出现新的丢弃时打印，平时不刷屏
+    void log_channel_stats(int64_t now_us)
+    {
+        if (now_us < next_stats_us) {
+            return;
+        }
+        next_stats_us = now_us + (int64_t)CHANNEL_STATS_INTERVAL_MS * 1000;
+        const auto euler = bno055->get_euler_channel().get_stats();
+        const auto features = dsp_engine->getFeaturesChannel().get_stats();
+        if (euler.dropped + features.dropped == last_dropped) {
+            return;
+        }
+        last_dropped = euler.dropped + features.dropped;
+        ESP_LOGW(TAG, "euler: produced %lu consumed %lu dropped %lu peak %lu; features: produced %lu consumed %lu dropped %lu peak %lu",
+            (unsigned long)euler.produced, (unsigned long)euler.consumed, (unsigned long)euler.dropped, (unsigned long)euler.peak_depth,
+            (unsigned long)features.produced, (unsigned long)features.consumed, (unsigned long)features.dropped, (unsigned long)features.peak_depth);
+    }
+
+    // 重连后按固定速率补发离线日志，最旧的先发；outbox 积压时暂停，实时批次优先
+    void replay_spool(int64_t now_us)
+    {
+        if (spool == nullptr || spool->empty() || now_us < next_replay_us
+            || mqtt_client->get_outbox_size() > SPOOL_REPLAY_MAX_OUTBOX) {
+            return;
+        }
+        next_replay_us = now_us + 1000000 / SPOOL_REPLAY_PER_SEC;
+        if (replay_buffer == nullptr) {
+            replay_buffer.reset(new uint8_t[REPLAY_BUFFER_BYTES]);
+        }
+        char topic[64];
+        size_t len = 0;
+        esp_err_t ret = spool->peek(topic, sizeof(topic), replay_buffer.get(), REPLAY_BUFFER_BYTES, &len);
+        if (ret == ESP_ERR_INVALID_SIZE) {
+            ESP_LOGW(TAG, "spooled batch too large, skipped");
+            spool->pop();
+        } else if (ret == ESP_OK && mqtt_client->publish(topic, replay_buffer.get(), len, 1) >= 0) {
+            spool->pop();
+        }
+        if (spool->empty()) {
+            ESP_LOGI(TAG, "spool drained, %lu batches replayed", (unsigned long)spool->getReplayed());
+        }
+    }
+
+    // 命令在 MQTT 客户端任务中解析，只调用各模块线程安全的请求接口
+    void handle_command(const char* data, int len)
+    {
+        cJSON* root = cJSON_ParseWithLength(data, len);
+        if (root == nullptr) {
+            ESP_LOGW(TAG, "invalid command: %.*s", len, data);
+            return;
+        }
+        const cJSON* fft_size = cJSON_GetObjectItem(root, "fft_size");
+        if (cJSON_IsNumber(fft_size)) {
+            ESP_LOGI(TAG, "command: fft_size %d", fft_size->valueint);
+            dsp_engine->requestFFTSize(fft_size->valueint);
+        }
+        if (cJSON_IsTrue(cJSON_GetObjectItem(root, "reset_baseline"))) {
+            ESP_LOGI(TAG, "command: reset baseline");
+            dsp_engine->resetBaseline();
+        }
+        if (cJSON_IsTrue(cJSON_GetObjectItem(root, "capture"))) {
+            ESP_LOGI(TAG, "command: manual capture");
+            dsp_engine->getCapture().trigger(WaveformCapture::TRIGGER_MANUAL);
+        }
+        cJSON_Delete(root);
+    }
 };
 
 // 由于Wifi的连接与断开是在中断中，所以需要使用任务通知来触发MQTT连接与断开
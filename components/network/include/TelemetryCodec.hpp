@@ -0,0 +1,154 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+
+// 压缩编码用的位流工具，编码器与解码器共用；按高位在前写入，变长整数每 7 位一组、最高位表示后面还有
+class TelemetryCodec {
+public:
+    static uint64_t zigzag(int64_t value) { return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63); }
+    static int64_t unzigzag(uint64_t value) { return (int64_t)(value >> 1) ^ -(int64_t)(value & 1); }
+    static uint32_t floatBits(float value)
+    {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+    static float bitsFloat(uint32_t bits)
+    {
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+};
+
+// 写满后只置溢出标志，调用者在一条记录写完后统一检查，放不下就整条放弃
+class BitWriter {
+public:
+    BitWriter(uint8_t* out, int capacity)
+        : out(out)
+        , capacity(capacity) { };
+
+    void writeBits(uint32_t value, int count)
+    {
+        for (int i = count - 1; i >= 0; i--) {
+            if ((bit_pos & 7) == 0) {
+                if ((bit_pos >> 3) >= capacity) {
+                    overflow = true;
+                    return;
+                }
+                out[bit_pos >> 3] = 0;
+            }
+            if ((value >> i) & 1) {
+                out[bit_pos >> 3] |= 0x80 >> (bit_pos & 7);
+            }
+            bit_pos++;
+        }
+    }
+    void writeVarint(uint64_t value)
+    {
+        while (value >= 0x80) {
+            writeBits((uint32_t)(value & 0x7F) | 0x80, 8);
+            value >>= 7;
+        }
+        writeBits((uint32_t)value, 8);
+    }
+    // 补齐到整字节，返回写入的字节数，溢出返回 -1
+    int finish() const { return overflow ? -1 : (bit_pos + 7) >> 3; }
+
+private:
+    uint8_t* out;
+    int capacity;
+    int bit_pos = 0;
+    bool overflow = false;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* in, int len)
+        : in(in)
+        , len(len) { };
+
+    uint32_t readBits(int count)
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < count; i++) {
+            if ((bit_pos >> 3) >= len) {
+                overflow = true;
+                return 0;
+            }
+            value = (value << 1) | ((in[bit_pos >> 3] >> (7 - (bit_pos & 7))) & 1);
+            bit_pos++;
+        }
+        return value;
+    }
+    uint64_t readVarint()
+    {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const uint32_t byte = readBits(8);
+            value |= (uint64_t)(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0 || overflow) {
+                return value;
+            }
+        }
+        overflow = true;
+        return value;
+    }
+    // 每条记录以整字节结束
+    void alignToByte() { bit_pos = (bit_pos + 7) & ~7; }
+    int bytePos() const { return bit_pos >> 3; }
+    bool failed() const { return overflow; }
+
+private:
+    const uint8_t* in;
+    int len;
+    int bit_pos = 0;
+    bool overflow = false;
+};
+
+// Gorilla 风格的浮点压缩：与同一通道上一个值异或，相同写 1 位；
+// 有效位落在上次的窗口内时只写窗口内的位，否则写 5 位前导零个数、5 位有效位长度减一与有效位
+class FloatXorChannel {
+public:
+    void write(BitWriter& writer, float value)
+    {
+        const uint32_t bits = TelemetryCodec::floatBits(value);
+        const uint32_t x = bits ^ prev;
+        prev = bits;
+        if (x == 0) {
+            writer.writeBits(0, 1);
+            return;
+        }
+        const int lead = __builtin_clz(x) > 31 ? 31 : __builtin_clz(x);
+        const int trail = __builtin_ctz(x);
+        if (window_len > 0 && lead >= window_lead && trail >= 32 - window_lead - window_len) {
+            writer.writeBits(0b10, 2);
+            writer.writeBits(x >> (32 - window_lead - window_len), window_len);
+            return;
+        }
+        window_lead = lead;
+        window_len = 32 - lead - trail;
+        writer.writeBits(0b11, 2);
+        writer.writeBits(window_lead, 5);
+        writer.writeBits(window_len - 1, 5);
+        writer.writeBits(x >> trail, window_len);
+    }
+    float read(BitReader& reader)
+    {
+        if (reader.readBits(1) != 0) {
+            if (reader.readBits(1) != 0) {
+                window_lead = reader.readBits(5);
+                window_len = reader.readBits(5) + 1;
+            }
+            if (window_len > 0) {
+                prev ^= reader.readBits(window_len) << (32 - window_lead - window_len);
+            }
+        }
+        return TelemetryCodec::bitsFloat(prev);
+    }
+
+private:
+    uint32_t prev = 0;
+    int window_lead = 0;
+    int window_len = 0; // 0 表示还没有窗口
+};
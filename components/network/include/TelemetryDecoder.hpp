@@ -0,0 +1,171 @@
+#pragma once
+#include "SpectralFeatures.hpp"
+#include "TelemetryCodec.hpp"
+#include "TelemetryEncoder.hpp"
+#include <stdint.h>
+#include <string.h>
+
+// 二进制批次的参考解码器，网关侧按同样的步骤解码；除标准头文件外只依赖同样无外部依赖的编码定义与 SpectralFeatures.hpp，可以原样拿到主机或网关上编译
+// 姿态记录的时间戳按毫秒还原，第一条保留批头里完整的微秒时刻；特征记录按微秒还原，浮点字段逐位还原
+
+// 解码后的一条姿态记录，角度为原始计数，乘批头的 scale 得到度
+struct TelemetryEuler {
+    int64_t timestamp_us;
+    int16_t roll;
+    int16_t pitch;
+    int16_t yaw;
+};
+
+// TELEMETRY_SCHEMA_FEATURES_XOR 的字段布局与按轴的差分状态，编码器与解码器共用
+struct XorFeaturesLayout {
+    static constexpr int AXES = SPECTRAL_AXIS_VECTOR + 1;
+    static constexpr int FIELDS = 8 + 4 * SPECTRAL_TOP_K + SPECTRAL_MAX_BANDS;
+    struct AxisState {
+        int64_t last_ts;
+        int64_t last_dt;
+        FloatXorChannel fields[FIELDS];
+    };
+
+    static void resetAxes(AxisState* axes, int64_t base_time_us)
+    {
+        for (int axis = 0; axis < AXES; axis++) {
+            axes[axis] = {};
+            axes[axis].last_ts = base_time_us;
+        }
+    }
+    // 浮点字段按固定顺序展开与还原
+    static void gatherFields(const SpectralFeatures& features, float* fields)
+    {
+        int n = 0;
+        fields[n++] = features.dominant_freq_hz;
+        fields[n++] = features.dominant_psd;
+        fields[n++] = features.rms;
+        fields[n++] = features.crest_factor;
+        fields[n++] = features.centroid_hz;
+        fields[n++] = features.kurtosis;
+        fields[n++] = features.anomaly_score;
+        fields[n++] = features.anomaly_peak_z;
+        for (int i = 0; i < SPECTRAL_TOP_K; i++) {
+            fields[n++] = features.peaks[i].freq_hz;
+            fields[n++] = features.peaks[i].psd;
+            fields[n++] = features.envelope_peaks[i].freq_hz;
+            fields[n++] = features.envelope_peaks[i].psd;
+        }
+        for (int i = 0; i < SPECTRAL_MAX_BANDS; i++) {
+            fields[n++] = features.band_energy[i];
+        }
+    }
+    static void scatterFields(const float* fields, SpectralFeatures* features)
+    {
+        int n = 0;
+        features->dominant_freq_hz = fields[n++];
+        features->dominant_psd = fields[n++];
+        features->rms = fields[n++];
+        features->crest_factor = fields[n++];
+        features->centroid_hz = fields[n++];
+        features->kurtosis = fields[n++];
+        features->anomaly_score = fields[n++];
+        features->anomaly_peak_z = fields[n++];
+        for (int i = 0; i < SPECTRAL_TOP_K; i++) {
+            features->peaks[i].freq_hz = fields[n++];
+            features->peaks[i].psd = fields[n++];
+            features->envelope_peaks[i].freq_hz = fields[n++];
+            features->envelope_peaks[i].psd = fields[n++];
+        }
+        for (int i = 0; i < SPECTRAL_MAX_BANDS; i++) {
+            features->band_energy[i] = fields[n++];
+        }
+    }
+};
+
+class TelemetryDecoder {
+public:
+    // 读出并校验批头，返回记录数；格式不符或超过 max_records 返回 -1
+    static int readHeader(const uint8_t* payload, int len, uint8_t schema, int max_records, TelemetryBatchHeader* header)
+    {
+        if (len < (int)sizeof(*header)) {
+            return -1;
+        }
+        memcpy(header, payload, sizeof(*header));
+        if (header->magic != TELEMETRY_MAGIC || header->version != TELEMETRY_VERSION || header->schema != schema
+            || header->records > max_records) {
+            return -1;
+        }
+        return header->records;
+    }
+
+    static int decodePackedEuler(const uint8_t* payload, int len, TelemetryEuler* records, int max_records)
+    {
+        TelemetryBatchHeader header;
+        const int count = readHeader(payload, len, TELEMETRY_SCHEMA_EULER_PACKED, max_records, &header);
+        if (count < 0 || len != (int)(sizeof(header) + count * sizeof(PackedEulerSample))) {
+            return -1;
+        }
+        int64_t ms = header.base_time_us / 1000;
+        for (int i = 0; i < count; i++) {
+            PackedEulerSample sample;
+            memcpy(&sample, payload + sizeof(header) + i * sizeof(sample), sizeof(sample));
+            ms += sample.dt_ms;
+            records[i] = { (i == 0) ? header.base_time_us : ms * 1000, sample.roll, sample.pitch, sample.yaw };
+        }
+        return count;
+    }
+
+    static int decodeDeltaEuler(const uint8_t* payload, int len, TelemetryEuler* records, int max_records)
+    {
+        TelemetryBatchHeader header;
+        const int count = readHeader(payload, len, TELEMETRY_SCHEMA_EULER_DELTA, max_records, &header);
+        if (count < 0) {
+            return -1;
+        }
+        BitReader reader(payload + sizeof(header), len - sizeof(header));
+        int64_t ms = header.base_time_us / 1000;
+        int64_t dt_ms = 0;
+        TelemetryEuler last = {};
+        for (int i = 0; i < count; i++) {
+            dt_ms += TelemetryCodec::unzigzag(reader.readVarint());
+            ms += dt_ms;
+            // 角度差分按 int16 回绕
+            last.roll = (int16_t)(uint16_t)(last.roll + TelemetryCodec::unzigzag(reader.readVarint()));
+            last.pitch = (int16_t)(uint16_t)(last.pitch + TelemetryCodec::unzigzag(reader.readVarint()));
+            last.yaw = (int16_t)(uint16_t)(last.yaw + TelemetryCodec::unzigzag(reader.readVarint()));
+            if (reader.failed()) {
+                return -1;
+            }
+            last.timestamp_us = (i == 0) ? header.base_time_us : ms * 1000;
+            records[i] = last;
+        }
+        return reader.bytePos() == len - (int)sizeof(header) ? count : -1;
+    }
+
+    static int decodeXorFeatures(const uint8_t* payload, int len, SpectralFeatures* records, int max_records)
+    {
+        TelemetryBatchHeader header;
+        const int count = readHeader(payload, len, TELEMETRY_SCHEMA_FEATURES_XOR, max_records, &header);
+        if (count < 0) {
+            return -1;
+        }
+        XorFeaturesLayout::AxisState axes[XorFeaturesLayout::AXES];
+        XorFeaturesLayout::resetAxes(axes, header.base_time_us);
+        BitReader reader(payload + sizeof(header), len - sizeof(header));
+        for (int i = 0; i < count; i++) {
+            const int axis = reader.readBits(2);
+            XorFeaturesLayout::AxisState& state = axes[axis];
+            state.last_dt += TelemetryCodec::unzigzag(reader.readVarint());
+            state.last_ts += state.last_dt;
+            float fields[XorFeaturesLayout::FIELDS];
+            for (int f = 0; f < XorFeaturesLayout::FIELDS; f++) {
+                fields[f] = state.fields[f].read(reader);
+            }
+            reader.alignToByte();
+            if (reader.failed()) {
+                return -1;
+            }
+            records[i] = {};
+            records[i].timestamp_us = state.last_ts;
+            records[i].axis = axis;
+            XorFeaturesLayout::scatterFields(fields, &records[i]);
+        }
+        return reader.bytePos() == len - (int)sizeof(header) ? count : -1;
+    }
+};
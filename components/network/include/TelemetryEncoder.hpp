@@ -0,0 +1,92 @@
+#pragma once
+#include <stdint.h>
+
+#define TELEMETRY_MAGIC 0x4C54 // "TL"
+#define TELEMETRY_VERSION 1
+
+// 二进制批次的格式编号，写在批头里，接收端据此选择解码方式
+enum telemetry_schema_t : uint8_t {
+    TELEMETRY_SCHEMA_EULER_PACKED = 1, // 每条记录: uint16 时间差 (ms) + int16 roll/pitch/yaw 原始计数
+    TELEMETRY_SCHEMA_EULER_DELTA = 2, // 每条记录: 时间二阶差分 (ms) 与三个角度一阶差分，均为 zig-zag 变长整数
+    TELEMETRY_SCHEMA_FEATURES_XOR = 3, // 每条记录: 2 位轴号、时间二阶差分 (us) 与各浮点字段的 XOR 压缩位流，按字节补齐
+};
+
+// 所有二进制批次共用的头部，小端存放
+struct __attribute__((packed)) TelemetryBatchHeader {
+    uint16_t magic;
+    uint8_t version;
+    uint8_t schema; // telemetry_schema_t
+    uint16_t records;
+    uint16_t reserved;
+    int64_t base_time_us; // 第一条记录的时刻，esp_timer 时间基准
+    float scale; // 每个计数对应的物理量
+};
+
+// TELEMETRY_SCHEMA_EULER_PACKED 的一条记录，紧跟在批头之后依次排列
+struct __attribute__((packed)) PackedEulerSample {
+    uint16_t dt_ms; // 相对上一条记录，第一条为 0
+    int16_t roll;
+    int16_t pitch;
+    int16_t yaw;
+};
+
+// 一批负载的编码器：BatchPublisher 决定什么时候发，编码器决定批头、每条记录与批尾的字节格式
+// 编码器可以保存批内的差分状态，begin 时清除
+template <typename Record>
+class TelemetryEncoder {
+public:
+    virtual ~TelemetryEncoder() { };
+
+    // 开始新的一批，写入批头，返回写入的字节数；放不下返回 -1
+    virtual int begin(uint8_t* out, int capacity) = 0;
+    // 追加一条记录，返回写入的字节数；放不下或不能接在这一批后面时返回 -1，且不改变编码器状态
+    virtual int encode(const Record& record, uint8_t* out, int capacity) = 0;
+    // 结束这一批：batch 指向批头，可回填记录数；返回追加的批尾字节数，不超过 trailerSize()
+    virtual int end(uint8_t* batch, int len, int records) = 0;
+    // 需要为批尾预留的字节数
+    virtual int trailerSize() const { return 0; }
+};
+
+// JSON 数组：批头 '['，记录之间 ','，批尾 ']'；子类只负责把一条记录格式化成 JSON 对象
+template <typename Record>
+class JsonArrayEncoder : public TelemetryEncoder<Record> {
+public:
+    int begin(uint8_t* out, int capacity) override
+    {
+        if (capacity < 1) {
+            return -1;
+        }
+        out[0] = '[';
+        first = true;
+        return 1;
+    }
+    int encode(const Record& record, uint8_t* out, int capacity) override
+    {
+        const int sep = first ? 0 : 1;
+        if (capacity <= sep) {
+            return -1;
+        }
+        const int len = format(record, reinterpret_cast<char*>(out) + sep, capacity - sep);
+        if (len < 0) {
+            return -1;
+        }
+        if (sep) {
+            out[0] = ',';
+        }
+        first = false;
+        return sep + len;
+    }
+    int end(uint8_t* batch, int len, int) override
+    {
+        batch[len] = ']';
+        return 1;
+    }
+    int trailerSize() const override { return 1; }
+
+protected:
+    // 返回写入的字节数，放不下返回 -1
+    virtual int format(const Record& record, char* out, int capacity) = 0;
+
+private:
+    bool first = true;
+};
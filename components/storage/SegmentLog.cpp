@@ -0,0 +1,201 @@
+#include "SegmentLog.hpp"
+#include "Storage.hpp"
+#include "esp_rom_crc.h"
+#include <dirent.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+SegmentLog::~SegmentLog()
+{
+    if (writer != nullptr) {
+        fclose(writer);
+    }
+    if (reader != nullptr) {
+        fclose(reader);
+    }
+}
+
+void SegmentLog::segmentPath(uint32_t seq, char* path, size_t size) const
+{
+    snprintf(path, size, "%s/%08lx.seg", dir, (unsigned long)seq);
+}
+
+esp_err_t SegmentLog::open()
+{
+    if (!Storage::isMounted()) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    mkdir(dir, 0775);
+    DIR* d = opendir(dir);
+    if (d == nullptr) {
+        ESP_LOGE(TAG, "Failed to open %s", dir);
+        return ESP_FAIL;
+    }
+    // 分段按十六进制序号命名，找出最小与最大序号；中间缺失的分段在读取时跳过
+    bool found = false;
+    uint32_t min_seq = 0;
+    uint32_t max_seq = 0;
+    struct dirent* entry;
+    while ((entry = readdir(d)) != nullptr) {
+        char* end = nullptr;
+        const uint32_t seq = strtoul(entry->d_name, &end, 16);
+        if (end == entry->d_name || strcmp(end, ".seg") != 0) {
+            continue;
+        }
+        if (!found || seq < min_seq) {
+            min_seq = seq;
+        }
+        if (!found || seq > max_seq) {
+            max_seq = seq;
+        }
+        found = true;
+    }
+    closedir(d);
+    first_seq = found ? min_seq : 0;
+    end_seq = found ? max_seq + 1 : 0;
+    opened = true;
+    // 上次留下的最新分段可能以半条记录结尾，不再往里追加，下次写入新建分段
+    ESP_LOGI(TAG, "%s: %d segments pending", dir, getSegmentCount());
+    return ESP_OK;
+}
+
+void SegmentLog::dropOldest()
+{
+    if (reader != nullptr) {
+        fclose(reader);
+        reader = nullptr;
+    }
+    if (writing(first_seq)) {
+        fclose(writer);
+        writer = nullptr;
+    }
+    char path[64];
+    segmentPath(first_seq, path, sizeof(path));
+    remove(path);
+    first_seq++;
+    read_offset = 0;
+    peeked_size = 0;
+}
+
+esp_err_t SegmentLog::startSegment()
+{
+    if (writer != nullptr) {
+        fclose(writer);
+        writer = nullptr;
+    }
+    while (getSegmentCount() >= max_segments) {
+        evicted_segments++;
+        ESP_LOGW(TAG, "%s: full, evicting segment %08lx", dir, (unsigned long)first_seq);
+        dropOldest();
+    }
+    char path[64];
+    segmentPath(end_seq, path, sizeof(path));
+    writer = fopen(path, "wb");
+    if (writer == nullptr) {
+        ESP_LOGE(TAG, "Failed to create %s", path);
+        return ESP_FAIL;
+    }
+    end_seq++;
+    write_size = 0;
+    return ESP_OK;
+}
+
+esp_err_t SegmentLog::append(const char* topic, const void* data, size_t len)
+{
+    if (!opened) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    const size_t topic_len = strlen(topic);
+    const size_t entry_size = sizeof(EntryHeader) + topic_len + len;
+    if (topic_len > MAX_TOPIC || entry_size > segment_bytes) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (writer == nullptr || write_size + entry_size > segment_bytes) {
+        esp_err_t ret = startSegment();
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+    EntryHeader header = {};
+    header.magic = ENTRY_MAGIC;
+    header.topic_len = (uint8_t)topic_len;
+    header.data_len = (uint32_t)len;
+    header.crc = esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(topic), topic_len);
+    header.crc = esp_rom_crc32_le(header.crc, static_cast<const uint8_t*>(data), len);
+    bool ok = fwrite(&header, 1, sizeof(header), writer) == sizeof(header)
+        && fwrite(topic, 1, topic_len, writer) == topic_len
+        && fwrite(data, 1, len, writer) == len;
+    // 每条记录都落盘，掉电最多丢失正在写的这一条
+    ok = (fflush(writer) == 0) && (fsync(fileno(writer)) == 0) && ok;
+    if (!ok) {
+        // 分段里可能留下半条记录，关掉它，下一条写到新分段
+        ESP_LOGE(TAG, "%s: write failed", dir);
+        fclose(writer);
+        writer = nullptr;
+        return ESP_FAIL;
+    }
+    write_size += entry_size;
+    appended++;
+    return ESP_OK;
+}
+
+esp_err_t SegmentLog::peek(char* topic, size_t topic_size, void* data, size_t capacity, size_t* len)
+{
+    while (!empty()) {
+        if (reader == nullptr) {
+            char path[64];
+            segmentPath(first_seq, path, sizeof(path));
+            reader = fopen(path, "rb");
+            if (reader == nullptr) {
+                dropOldest(); // 缺失的分段
+                continue;
+            }
+        }
+        // 同一个文件可能正被追加，每次都重新定位，丢掉 stdio 缓存的文件尾状态
+        fseek(reader, read_offset, SEEK_SET);
+        EntryHeader header;
+        const size_t got = fread(&header, 1, sizeof(header), reader);
+        bool valid = got == sizeof(header) && header.magic == ENTRY_MAGIC && header.topic_len <= MAX_TOPIC
+            && header.data_len <= segment_bytes;
+        if (valid && (header.topic_len >= topic_size || header.data_len > capacity)) {
+            peeked_size = sizeof(header) + header.topic_len + header.data_len;
+            return ESP_ERR_INVALID_SIZE;
+        }
+        valid = valid && fread(topic, 1, header.topic_len, reader) == header.topic_len
+            && fread(data, 1, header.data_len, reader) == header.data_len;
+        if (valid) {
+            uint32_t crc = esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(topic), header.topic_len);
+            crc = esp_rom_crc32_le(crc, static_cast<const uint8_t*>(data), header.data_len);
+            valid = crc == header.crc;
+        }
+        if (valid) {
+            topic[header.topic_len] = '\0';
+            *len = header.data_len;
+            peeked_size = sizeof(header) + header.topic_len + header.data_len;
+            return ESP_OK;
+        }
+        if (got != 0) {
+            corrupted++;
+            ESP_LOGW(TAG, "%s: corrupted entry in segment %08lx, skipping the rest", dir, (unsigned long)first_seq);
+        }
+        // 分段读完或剩余部分损坏：删除这个分段，正在写的分段也一并结束
+        dropOldest();
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+void SegmentLog::pop()
+{
+    if (peeked_size == 0) {
+        return;
+    }
+    read_offset += peeked_size;
+    peeked_size = 0;
+    replayed++;
+    // 追上了正在写的分段：直接结束并删除它，下一条写入新分段，日志回到空状态
+    if (writing(first_seq) && (size_t)read_offset >= write_size) {
+        dropOldest();
+    }
+}
@@ -0,0 +1,91 @@
+#include "Storage.hpp"
+#include "esp_littlefs.h"
+#include <stdio.h>
+#include <string.h>
+
+bool Storage::mounted = false;
+
+esp_err_t Storage::mount()
+{
+    if (mounted) {
+        return ESP_OK;
+    }
+    esp_vfs_littlefs_conf_t conf = {};
+    conf.base_path = BASE_PATH;
+    conf.partition_label = PARTITION_LABEL;
+    conf.format_if_mount_failed = true;
+    conf.dont_mount = false;
+    esp_err_t ret = esp_vfs_littlefs_register(&conf);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to mount LittleFS: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    size_t total = 0;
+    size_t used = 0;
+    esp_littlefs_info(PARTITION_LABEL, &total, &used);
+    ESP_LOGI(TAG, "LittleFS mounted at %s, used %u / %u bytes", BASE_PATH, (unsigned)used, (unsigned)total);
+    mounted = true;
+    return ESP_OK;
+}
+
+esp_err_t Storage::writeFile(const char* path, const void* header, size_t header_size, const void* data, size_t data_size)
+{
+    return writeFile(path, header, header_size, &data, data_size, 1);
+}
+
+esp_err_t Storage::readFile(const char* path, void* header, size_t header_size, void* data, size_t data_size)
+{
+    return readFile(path, header, header_size, &data, data_size, 1);
+}
+
+esp_err_t Storage::writeFile(const char* path, const void* header, size_t header_size,
+    const void* const* parts, size_t part_size, int part_count)
+{
+    if (!mounted) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    char tmp_path[64];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    FILE* f = fopen(tmp_path, "wb");
+    if (f == nullptr) {
+        ESP_LOGE(TAG, "Failed to open %s", tmp_path);
+        return ESP_FAIL;
+    }
+    bool ok = fwrite(header, 1, header_size, f) == header_size;
+    for (int i = 0; ok && i < part_count; i++) {
+        ok = fwrite(parts[i], 1, part_size, f) == part_size;
+    }
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) {
+        ESP_LOGE(TAG, "Failed to write %s", tmp_path);
+        remove(tmp_path);
+        return ESP_FAIL;
+    }
+    // LittleFS 的 rename 会原子地覆盖目标文件；万一失败再删掉旧文件重试
+    if (rename(tmp_path, path) != 0) {
+        remove(path);
+        if (rename(tmp_path, path) != 0) {
+            ESP_LOGE(TAG, "Failed to rename %s", tmp_path);
+            return ESP_FAIL;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t Storage::readFile(const char* path, void* header, size_t header_size,
+    void* const* parts, size_t part_size, int part_count)
+{
+    if (!mounted) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    FILE* f = fopen(path, "rb");
+    if (f == nullptr) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    bool ok = fread(header, 1, header_size, f) == header_size;
+    for (int i = 0; ok && i < part_count; i++) {
+        ok = fread(parts[i], 1, part_size, f) == part_size;
+    }
+    fclose(f);
+    return ok ? ESP_OK : ESP_ERR_INVALID_SIZE;
+}
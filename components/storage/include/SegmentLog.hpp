@@ -0,0 +1,68 @@
+#pragma once
+#include "esp_err.h"
+#include "esp_log.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// 追加式分段日志，用于断网期间暂存发不出去的消息：每个分段一个文件，只在最新分段末尾追加，从最旧分段开头读取
+// 一个分段读完后整个删除；分段数达到上限时淘汰最旧的分段，总占用不超过 segment_bytes * max_segments
+// 每条记录带 CRC，掉电留下的半条记录在读取时丢弃；启动时已有的分段会继续补发，读到一半的分段可能重复发送
+// 只在一个任务中使用，不加锁
+class SegmentLog {
+public:
+    SegmentLog(const char* dir, size_t segment_bytes, int max_segments)
+        : dir(dir)
+        , segment_bytes(segment_bytes)
+        , max_segments(max_segments < 2 ? 2 : max_segments) { };
+    ~SegmentLog();
+
+    // 在 Storage::mount() 之后调用：创建目录并找出上次留下的分段
+    esp_err_t open();
+    esp_err_t append(const char* topic, const void* data, size_t len);
+    // 读出最旧的一条但不移除；日志为空返回 ESP_ERR_NOT_FOUND，缓冲区不够返回 ESP_ERR_INVALID_SIZE，此时可以 pop 跳过
+    esp_err_t peek(char* topic, size_t topic_size, void* data, size_t capacity, size_t* len);
+    // 移除上一次 peek 读出的记录
+    void pop();
+    bool empty() const { return first_seq == end_seq; }
+
+    int getSegmentCount() const { return (int)(end_seq - first_seq); }
+    uint32_t getAppended() const { return appended; }
+    uint32_t getReplayed() const { return replayed; }
+    uint32_t getEvictedSegments() const { return evicted_segments; }
+    uint32_t getCorrupted() const { return corrupted; }
+
+private:
+    static constexpr auto TAG = "SegmentLog";
+    static constexpr uint16_t ENTRY_MAGIC = 0x4753; // "SG"
+    static constexpr size_t MAX_TOPIC = 63;
+
+    struct __attribute__((packed)) EntryHeader {
+        uint16_t magic;
+        uint8_t topic_len;
+        uint8_t reserved;
+        uint32_t data_len;
+        uint32_t crc; // topic 与 data 的 CRC32
+    };
+
+    const char* dir;
+    size_t segment_bytes;
+    int max_segments;
+    bool opened = false;
+    uint32_t first_seq = 0; // 最旧的分段
+    uint32_t end_seq = 0; // 下一个新建分段的编号，[first_seq, end_seq) 为现存分段
+    FILE* writer = nullptr; // 正在追加的分段，总是 end_seq - 1
+    size_t write_size = 0;
+    FILE* reader = nullptr; // 正在读取的分段，总是 first_seq
+    long read_offset = 0;
+    size_t peeked_size = 0;
+    uint32_t appended = 0;
+    uint32_t replayed = 0;
+    uint32_t evicted_segments = 0;
+    uint32_t corrupted = 0;
+
+    void segmentPath(uint32_t seq, char* path, size_t size) const;
+    esp_err_t startSegment();
+    void dropOldest();
+    bool writing(uint32_t seq) const { return writer != nullptr && seq + 1 == end_seq; }
+};
@@ -0,0 +1,27 @@
+#pragma once
+#include "esp_err.h"
+#include "esp_log.h"
+#include <stddef.h>
+
+// 分区表中的 storage 分区 (LittleFS)，挂载到 /storage，断电后保留基线等需要持久化的数据
+class Storage {
+public:
+    static constexpr auto BASE_PATH = "/storage";
+    static constexpr auto PARTITION_LABEL = "storage";
+
+    static esp_err_t mount(); // 重复调用直接返回 ESP_OK；挂载失败时格式化分区
+    static bool isMounted() { return mounted; }
+
+    // 整个文件读写：写入先落到临时文件再改名，掉电时不会留下写了一半的文件
+    static esp_err_t writeFile(const char* path, const void* header, size_t header_size, const void* data, size_t data_size);
+    static esp_err_t readFile(const char* path, void* header, size_t header_size, void* data, size_t data_size);
+    // 数据分成 part_count 段、每段 part_size 字节，分别位于不同的缓冲区，在文件里依次连续存放
+    static esp_err_t writeFile(const char* path, const void* header, size_t header_size,
+        const void* const* parts, size_t part_size, int part_count);
+    static esp_err_t readFile(const char* path, void* header, size_t header_size,
+        void* const* parts, size_t part_size, int part_count);
+
+private:
+    static constexpr auto TAG = "Storage";
+    static bool mounted;
+};
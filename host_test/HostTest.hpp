@@ -0,0 +1,28 @@
+#pragma once
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// 主机测试的断言：失败时打印位置并以非零值退出，ctest 据此判定失败
+#define HOST_CHECK(cond)                                                              \
+    do {                                                                              \
+        if (!(cond)) {                                                                \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            exit(1);                                                                  \
+        }                                                                             \
+    } while (0)
+
+// 基准计时用的单调时钟，单位 ns
+static inline int64_t hostNowNs()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// 让编译器认为 value 被读取过，基准里的计算不会被整个优化掉
+template <typename T>
+static inline void hostKeep(const T& value)
+{
+    asm volatile("" : : "r"(&value) : "memory");
+}
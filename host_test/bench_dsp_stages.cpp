@@ -0,0 +1,136 @@
+// DSPEngine 浮点路径各阶段每帧耗时，单轴与三轴对比
+// 与 DSPEngine::run 相同的处理链与 Welch 线性平均；三轴时另有矢量合成谱与矢量通道的特征提取
+// 加窗、FFT、周期图、Welch 累加都是逐轴进行的，三轴就是三份；这里给出的比值即三轴相对单轴的实际开销
+#include "HostTest.hpp"
+#include "APPConfig.h"
+#include "DSPPipeline.hpp"
+#include "SpectralFeatures.hpp"
+#include <math.h>
+#include <string.h>
+
+namespace {
+
+constexpr int FRAMES = 400;
+constexpr int FFT_SIZE = N_SAMPLES;
+constexpr int BINS = FFT_SIZE / 2;
+constexpr int MAX_AXES = 3;
+constexpr uint32_t SAMPLE_RATE_HZ = VIBRATION_SAMPLE_RATE_HZ;
+
+enum stage_t {
+    STAGE_WINDOW = 0,
+    STAGE_FFT,
+    STAGE_POWER,
+    STAGE_WELCH,
+    STAGE_VECTOR,
+    STAGE_FEATURES,
+    STAGE_COUNT,
+};
+const char* const STAGE_NAMES[STAGE_COUNT] = { "window", "fft", "power", "welch", "vector", "features" };
+
+using AxisPipeline = Pipeline<Window<HannShape, DSP_FFT_MAX_SAMPLES>, RealFFT<DSP_FFT_MAX_SAMPLES>, Periodogram<DSP_FFT_MAX_SAMPLES>>;
+AxisPipeline pipeline;
+float history[MAX_AXES][FFT_SIZE];
+float psd_acc[MAX_AXES][BINS];
+float psd_avg[MAX_AXES + 1][BINS];
+
+// 各轴不同频率的正弦加噪声
+void makeHistory()
+{
+    uint32_t seed = 1;
+    for (int axis = 0; axis < MAX_AXES; axis++) {
+        for (int i = 0; i < FFT_SIZE; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            const float noise = ((int32_t)(seed >> 8) - (1 << 23)) / (float)(1 << 23);
+            history[axis][i] = sinf(2 * (float)M_PI * (37.0f + 50.0f * axis) * i / SAMPLE_RATE_HZ) + 0.1f * noise;
+        }
+    }
+}
+
+struct Profile {
+    double stage_ns[STAGE_COUNT];
+    double total_ns;
+};
+
+Profile runFrames(int axes)
+{
+    SpectralFeatureExtractor extractor;
+    extractor.setDefaultBands(SAMPLE_RATE_HZ);
+    const int channels = axes > 1 ? axes + 1 : axes;
+    int64_t stage_ns[STAGE_COUNT] = {};
+    int segments = 0;
+    int history_pos = 0;
+    for (int frame = 0; frame < FRAMES; frame++) {
+        history_pos = (history_pos + DSP_BLOCK_SAMPLES) % FFT_SIZE;
+        int64_t t = hostNowNs();
+        for (int axis = 0; axis < axes; axis++) {
+            const float* power = pipeline.run(RingInput { history[axis], history_pos }, [&](size_t stage) {
+                const int64_t now = hostNowNs();
+                stage_ns[STAGE_WINDOW + stage] += now - t;
+                t = now;
+            });
+            dsps_add_f32(psd_acc[axis], power, psd_acc[axis], BINS, 1, 1, 1);
+            const int64_t now = hostNowNs();
+            stage_ns[STAGE_WELCH] += now - t;
+            t = now;
+        }
+        if (++segments < WELCH_AVERAGES) {
+            continue;
+        }
+        for (int axis = 0; axis < axes; axis++) {
+            dsps_mulc_f32(psd_acc[axis], psd_avg[axis], BINS, 1.0f / segments, 1, 1);
+            memset(psd_acc[axis], 0, sizeof(psd_acc[axis]));
+        }
+        segments = 0;
+        int64_t now = hostNowNs();
+        stage_ns[STAGE_WELCH] += now - t;
+        t = now;
+        if (axes > 1) {
+            memcpy(psd_avg[axes], psd_avg[0], sizeof(psd_avg[0]));
+            for (int axis = 1; axis < axes; axis++) {
+                dsps_add_f32(psd_avg[axes], psd_avg[axis], psd_avg[axes], BINS, 1, 1, 1);
+            }
+            now = hostNowNs();
+            stage_ns[STAGE_VECTOR] += now - t;
+            t = now;
+        }
+        for (int channel = 0; channel < channels; channel++) {
+            SpectralFeatures features;
+            extractor.extract(psd_avg[channel], BINS, SAMPLE_RATE_HZ, history[channel % axes], FFT_SIZE, &features);
+            hostKeep(features);
+        }
+        stage_ns[STAGE_FEATURES] += hostNowNs() - t;
+    }
+    Profile profile = {};
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        profile.stage_ns[stage] = (double)stage_ns[stage] / FRAMES;
+        profile.total_ns += profile.stage_ns[stage];
+    }
+    return profile;
+}
+
+}
+
+int main()
+{
+    PipelineContext ctx = { SAMPLE_RATE_HZ, FFT_SIZE, 0 };
+    HOST_CHECK(pipeline.init(ctx) == ESP_OK);
+    makeHistory();
+    runFrames(MAX_AXES); // 预热
+    const Profile single = runFrames(1);
+    const Profile triple = runFrames(MAX_AXES);
+
+    printf("ns/frame, %d points, Welch average of %d, features per averaged frame amortised\n", FFT_SIZE, WELCH_AVERAGES);
+    printf("  %-10s %10s %10s %7s\n", "stage", "1 axis", "3 axes", "ratio");
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        printf("  %-10s %10.0f %10.0f %7.2f\n", STAGE_NAMES[stage], single.stage_ns[stage], triple.stage_ns[stage],
+            single.stage_ns[stage] > 0 ? triple.stage_ns[stage] / single.stage_ns[stage] : 0.0);
+    }
+    printf("  %-10s %10.0f %10.0f %7.2f\n", "total", single.total_ns, triple.total_ns, triple.total_ns / single.total_ns);
+
+    // 矢量合成谱是各轴平均谱之和
+    for (int i = 0; i < BINS; i++) {
+        const float sum = psd_avg[0][i] + psd_avg[1][i] + psd_avg[2][i];
+        HOST_CHECK(fabsf(psd_avg[MAX_AXES][i] - sum) <= 1e-5f * sum + 1e-12f);
+    }
+    return 0;
+}
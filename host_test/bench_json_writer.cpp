@@ -0,0 +1,186 @@
+// JSON 记录的格式化耗时：JsonWriter (JsonEulerEncoder / JsonFeaturesEncoder) 对比同样格式的 snprintf 与 cJSON
+// 主机有硬件双精度，snprintf 与 cJSON 的 double 运算在这里不贵；ESP32-S3 上它们走软件双精度，差距比这里更大
+// cJSON 取自 ESP-IDF 的 json 组件，没有设置 IDF_PATH 时只对比 snprintf
+#include "HostTest.hpp"
+#include "EulerEncoder.hpp"
+#include "FeaturesEncoder.hpp"
+#include <inttypes.h>
+#include <string.h>
+#if HOST_HAVE_CJSON
+#include "cJSON.h"
+#endif
+
+namespace {
+
+constexpr int ITERATIONS = 200000;
+constexpr int BUFFER_BYTES = 1024;
+static_assert(SPECTRAL_TOP_K == 4 && SPECTRAL_MAX_BANDS == 4, "snprintf reference below spells out 4 peaks and 4 bands");
+
+char writer_out[BUFFER_BYTES];
+char reference_out[BUFFER_BYTES];
+
+EulerRecord makeEuler(int i)
+{
+    return { 1700000000000000LL + (int64_t)i * 10000, { (int16_t)(i % 5760), (int16_t)(-(i % 2880)), (int16_t)(i * 7 % 5760) } };
+}
+
+SpectralFeatures makeFeatures(int i)
+{
+    SpectralFeatures f = {};
+    f.timestamp_us = 1700000000000000LL + (int64_t)i * 512000;
+    f.axis = i % 4;
+    f.dominant_freq_hz = 49.8f + 0.01f * (i % 13);
+    f.dominant_psd = 1.5e-3f * (1.0f + 0.001f * i);
+    for (int k = 0; k < SPECTRAL_TOP_K; k++) {
+        f.peaks[k] = { 49.8f * (k + 1), f.dominant_psd / (k + 1) };
+        f.envelope_peaks[k] = { 12.25f * (k + 1), 2e-5f * (k + 1) };
+        f.band_energy[k] = 1e-4f * (k + 1) + 1e-7f * i;
+    }
+    f.rms = 0.0213f + 1e-5f * i;
+    f.crest_factor = 1.414f;
+    f.centroid_hz = 120.5f;
+    f.kurtosis = 1.52f;
+    f.anomaly_score = 0.1f * (i % 9);
+    f.anomaly_peak_z = -0.5f;
+    return f;
+}
+
+// 与 JsonEulerEncoder 相同的输出
+int snprintfEuler(const EulerRecord& r, char* out, int capacity)
+{
+    const float scale = 1.0f / 16.0f;
+    return snprintf(out, capacity, "{\"t\":%" PRId64 ",\"roll\":%.2f,\"pitch\":%.2f,\"yaw\":%.2f}", r.timestamp_us / 1000,
+        r.euler.r * scale, r.euler.p * scale, r.euler.h * scale);
+}
+
+// 与 JsonFeaturesEncoder 相同的输出
+int snprintfFeatures(const SpectralFeatures& f, char* out, int capacity)
+{
+    return snprintf(out, capacity,
+        "{\"ts\":%" PRId64 ",\"axis\":%d,\"f0\":%.2f,\"p0\":%.3e,\"rms\":%.4f,\"crest\":%.2f,\"centroid\":%.2f,\"kurtosis\":%.2f,"
+        "\"score\":%.2f,\"peak_z\":%.2f,\"peaks\":[[%.2f,%.3e],[%.2f,%.3e],[%.2f,%.3e],[%.2f,%.3e]],"
+        "\"bands\":[%.3e,%.3e,%.3e,%.3e],\"env\":[[%.2f,%.3e],[%.2f,%.3e],[%.2f,%.3e],[%.2f,%.3e]]}",
+        f.timestamp_us, f.axis, f.dominant_freq_hz, f.dominant_psd, f.rms, f.crest_factor, f.centroid_hz, f.kurtosis,
+        f.anomaly_score, f.anomaly_peak_z,
+        f.peaks[0].freq_hz, f.peaks[0].psd, f.peaks[1].freq_hz, f.peaks[1].psd,
+        f.peaks[2].freq_hz, f.peaks[2].psd, f.peaks[3].freq_hz, f.peaks[3].psd,
+        f.band_energy[0], f.band_energy[1], f.band_energy[2], f.band_energy[3],
+        f.envelope_peaks[0].freq_hz, f.envelope_peaks[0].psd, f.envelope_peaks[1].freq_hz, f.envelope_peaks[1].psd,
+        f.envelope_peaks[2].freq_hz, f.envelope_peaks[2].psd, f.envelope_peaks[3].freq_hz, f.envelope_peaks[3].psd);
+}
+
+// 编码器的一条记录：每次从新的一批开始，输出里没有分隔符，与 snprintf 的结果可以直接比较
+template <typename Record>
+int encodeRecord(TelemetryEncoder<Record>& encoder, const Record& record, char* out, int capacity)
+{
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(out);
+    const int head = encoder.begin(bytes, capacity);
+    const int len = encoder.encode(record, bytes + head, capacity - head - 1);
+    HOST_CHECK(head == 1 && len > 0);
+    memmove(out, out + head, len);
+    out[len] = '\0';
+    return len;
+}
+
+#if HOST_HAVE_CJSON
+void addPeaks(cJSON* root, const char* name, const SpectralFeatures::Peak* peaks)
+{
+    cJSON* array = cJSON_AddArrayToObject(root, name);
+    for (int k = 0; k < SPECTRAL_TOP_K; k++) {
+        const float pair[2] = { peaks[k].freq_hz, peaks[k].psd };
+        cJSON_AddItemToArray(array, cJSON_CreateFloatArray(pair, 2));
+    }
+}
+
+int cjsonEuler(const EulerRecord& r, char* out, int capacity)
+{
+    const float scale = 1.0f / 16.0f;
+    cJSON* root = cJSON_CreateObject();
+    cJSON_AddNumberToObject(root, "t", (double)(r.timestamp_us / 1000));
+    cJSON_AddNumberToObject(root, "roll", r.euler.r * scale);
+    cJSON_AddNumberToObject(root, "pitch", r.euler.p * scale);
+    cJSON_AddNumberToObject(root, "yaw", r.euler.h * scale);
+    const bool ok = cJSON_PrintPreallocated(root, out, capacity, false);
+    cJSON_Delete(root);
+    return ok ? (int)strlen(out) : -1;
+}
+
+int cjsonFeatures(const SpectralFeatures& f, char* out, int capacity)
+{
+    cJSON* root = cJSON_CreateObject();
+    cJSON_AddNumberToObject(root, "ts", (double)f.timestamp_us);
+    cJSON_AddNumberToObject(root, "axis", f.axis);
+    cJSON_AddNumberToObject(root, "f0", f.dominant_freq_hz);
+    cJSON_AddNumberToObject(root, "p0", f.dominant_psd);
+    cJSON_AddNumberToObject(root, "rms", f.rms);
+    cJSON_AddNumberToObject(root, "crest", f.crest_factor);
+    cJSON_AddNumberToObject(root, "centroid", f.centroid_hz);
+    cJSON_AddNumberToObject(root, "kurtosis", f.kurtosis);
+    cJSON_AddNumberToObject(root, "score", f.anomaly_score);
+    cJSON_AddNumberToObject(root, "peak_z", f.anomaly_peak_z);
+    addPeaks(root, "peaks", f.peaks);
+    cJSON_AddItemToObject(root, "bands", cJSON_CreateFloatArray(f.band_energy, SPECTRAL_MAX_BANDS));
+    addPeaks(root, "env", f.envelope_peaks);
+    const bool ok = cJSON_PrintPreallocated(root, out, capacity, false);
+    cJSON_Delete(root);
+    return ok ? (int)strlen(out) : -1;
+}
+#endif
+
+// 每条记录的平均耗时 (ns)
+template <typename Format>
+double timePerRecord(Format format)
+{
+    int64_t bytes = 0;
+    const int64_t start = hostNowNs();
+    for (int i = 0; i < ITERATIONS; i++) {
+        bytes += format(i);
+    }
+    const int64_t elapsed = hostNowNs() - start;
+    hostKeep(bytes);
+    return (double)elapsed / ITERATIONS;
+}
+
+} // namespace
+
+int main()
+{
+    JsonEulerEncoder euler_encoder;
+    JsonFeaturesEncoder features_encoder;
+
+    // 先确认两种写法输出完全相同
+    for (int i = 0; i < 1000; i++) {
+        const EulerRecord euler = makeEuler(i * 37);
+        encodeRecord<EulerRecord>(euler_encoder, euler, writer_out, BUFFER_BYTES);
+        snprintfEuler(euler, reference_out, BUFFER_BYTES);
+        HOST_CHECK(strcmp(writer_out, reference_out) == 0);
+        const SpectralFeatures features = makeFeatures(i);
+        encodeRecord<SpectralFeatures>(features_encoder, features, writer_out, BUFFER_BYTES);
+        snprintfFeatures(features, reference_out, BUFFER_BYTES);
+        HOST_CHECK(strcmp(writer_out, reference_out) == 0);
+    }
+
+    const double euler_writer = timePerRecord([&](int i) {
+        return encodeRecord<EulerRecord>(euler_encoder, makeEuler(i), writer_out, BUFFER_BYTES);
+    });
+    const double euler_snprintf = timePerRecord([&](int i) { return snprintfEuler(makeEuler(i), reference_out, BUFFER_BYTES); });
+    const double features_writer = timePerRecord([&](int i) {
+        return encodeRecord<SpectralFeatures>(features_encoder, makeFeatures(i), writer_out, BUFFER_BYTES);
+    });
+    const double features_snprintf = timePerRecord([&](int i) {
+        return snprintfFeatures(makeFeatures(i), reference_out, BUFFER_BYTES);
+    });
+
+    printf("ns per record, %d records\n", ITERATIONS);
+    printf("  %-10s %10s %10s %10s\n", "", "JsonWriter", "snprintf", "cJSON");
+#if HOST_HAVE_CJSON
+    const double euler_cjson = timePerRecord([&](int i) { return cjsonEuler(makeEuler(i), reference_out, BUFFER_BYTES); });
+    const double features_cjson = timePerRecord([&](int i) { return cjsonFeatures(makeFeatures(i), reference_out, BUFFER_BYTES); });
+    printf("  %-10s %10.1f %10.1f %10.1f\n", "euler", euler_writer, euler_snprintf, euler_cjson);
+    printf("  %-10s %10.1f %10.1f %10.1f\n", "features", features_writer, features_snprintf, features_cjson);
+#else
+    printf("  %-10s %10.1f %10.1f %10s\n", "euler", euler_writer, euler_snprintf, "-");
+    printf("  %-10s %10.1f %10.1f %10s\n", "features", features_writer, features_snprintf, "-");
+#endif
+    return 0;
+}
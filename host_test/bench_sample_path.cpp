@@ -0,0 +1,157 @@
+// 采集到消费者的换算与队列开销，对比 user-003 之前与之后的样本路径
+// 之前：驱动里把 s16 换算成 double（S3 上是软件模拟），姿态角按 3 个 double、线性加速度按 1 个 double 入队，DSP 再转成 float
+// 之后：队列里传原始 s16，消费者在末端乘一次编译期的 float 比例系数
+// 主机有硬件双精度，另用软件实现的 __float128 代替 double 跑一遍之前的路径，近似 S3 上软件模拟双精度的开销
+// 队列部分是每个元素的拷贝与加锁开销；主机上加锁占大头，元素从 32 字节减到 8 字节的收益在这里体现不明显
+#include "HostTest.hpp"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include <math.h>
+
+extern "C" {
+#include "bno055.h"
+}
+
+namespace {
+
+constexpr int SAMPLES = 200000;
+constexpr int QUEUE_DEPTH = 64; // 每次灌满再取空，只测队列本身，不含任务切换
+constexpr float EULER_SCALE_DEG = 1.0f / (float)BNO055_EULER_DIV_DEG;
+constexpr float LINEAR_ACCEL_SCALE_MSQ = 1.0f / (float)BNO055_LINEAR_ACCEL_DIV_MSQ;
+
+struct RawSample {
+    bno055_euler_t euler;
+    s16 linear_accel_z;
+};
+
+RawSample raw_samples[QUEUE_DEPTH];
+
+void makeSamples()
+{
+    for (int i = 0; i < QUEUE_DEPTH; i++) {
+        raw_samples[i].euler = { (s16)(i * 37 - 900), (s16)(i * 11 + 5), (s16)(5760 - i * 53) };
+        raw_samples[i].linear_accel_z = (s16)(i * 97 - 3000);
+    }
+}
+
+struct Result {
+    double convert_ns;
+    double queue_ns;
+    float checksum;
+};
+
+template <typename Real>
+struct EulerReal {
+    Real h;
+    Real r;
+    Real p;
+};
+
+// 之前：bno055_convert_double_euler_hpr_deg / bno055_convert_double_linear_accel_z_msq 的换算
+template <typename Real>
+Result runDouble()
+{
+    QueueHandle_t euler_queue = xQueueCreate(QUEUE_DEPTH, sizeof(EulerReal<Real>));
+    QueueHandle_t accel_queue = xQueueCreate(QUEUE_DEPTH, sizeof(Real));
+    EulerReal<Real> euler[QUEUE_DEPTH];
+    Real accel[QUEUE_DEPTH];
+    float out[QUEUE_DEPTH];
+    Result result = {};
+    int64_t convert_ns = 0;
+    int64_t queue_ns = 0;
+    for (int done = 0; done < SAMPLES; done += QUEUE_DEPTH) {
+        int64_t t0 = hostNowNs();
+        for (int i = 0; i < QUEUE_DEPTH; i++) {
+            euler[i].h = raw_samples[i].euler.h / (Real)BNO055_EULER_DIV_DEG;
+            euler[i].r = raw_samples[i].euler.r / (Real)BNO055_EULER_DIV_DEG;
+            euler[i].p = raw_samples[i].euler.p / (Real)BNO055_EULER_DIV_DEG;
+            accel[i] = raw_samples[i].linear_accel_z / (Real)BNO055_LINEAR_ACCEL_DIV_MSQ;
+        }
+        hostKeep(euler);
+        hostKeep(accel);
+        int64_t t1 = hostNowNs();
+        for (int i = 0; i < QUEUE_DEPTH; i++) {
+            xQueueSend(euler_queue, &euler[i], 0);
+            xQueueSend(accel_queue, &accel[i], 0);
+        }
+        for (int i = 0; i < QUEUE_DEPTH; i++) {
+            xQueueReceive(euler_queue, &euler[i], 0);
+            xQueueReceive(accel_queue, &accel[i], 0);
+        }
+        int64_t t2 = hostNowNs();
+        for (int i = 0; i < QUEUE_DEPTH; i++) {
+            out[i] = (float)euler[i].h + (float)euler[i].r + (float)euler[i].p + (float)accel[i];
+        }
+        hostKeep(out);
+        convert_ns += (t1 - t0) + (hostNowNs() - t2);
+        queue_ns += t2 - t1;
+    }
+    for (int i = 0; i < QUEUE_DEPTH; i++) {
+        result.checksum += out[i];
+    }
+    result.convert_ns = (double)convert_ns / SAMPLES;
+    result.queue_ns = (double)queue_ns / SAMPLES;
+    vQueueDelete(euler_queue);
+    vQueueDelete(accel_queue);
+    return result;
+}
+
+// 之后：原始 s16 入队，消费者乘 float 比例系数
+Result runRaw()
+{
+    QueueHandle_t euler_queue = xQueueCreate(QUEUE_DEPTH, sizeof(bno055_euler_t));
+    QueueHandle_t accel_queue = xQueueCreate(QUEUE_DEPTH, sizeof(s16));
+    bno055_euler_t euler[QUEUE_DEPTH];
+    s16 accel[QUEUE_DEPTH];
+    float out[QUEUE_DEPTH];
+    Result result = {};
+    int64_t convert_ns = 0;
+    int64_t queue_ns = 0;
+    for (int done = 0; done < SAMPLES; done += QUEUE_DEPTH) {
+        int64_t t1 = hostNowNs();
+        for (int i = 0; i < QUEUE_DEPTH; i++) {
+            xQueueSend(euler_queue, &raw_samples[i].euler, 0);
+            xQueueSend(accel_queue, &raw_samples[i].linear_accel_z, 0);
+        }
+        for (int i = 0; i < QUEUE_DEPTH; i++) {
+            xQueueReceive(euler_queue, &euler[i], 0);
+            xQueueReceive(accel_queue, &accel[i], 0);
+        }
+        int64_t t2 = hostNowNs();
+        for (int i = 0; i < QUEUE_DEPTH; i++) {
+            out[i] = euler[i].h * EULER_SCALE_DEG + euler[i].r * EULER_SCALE_DEG + euler[i].p * EULER_SCALE_DEG
+                + accel[i] * LINEAR_ACCEL_SCALE_MSQ;
+        }
+        hostKeep(out);
+        convert_ns += hostNowNs() - t2;
+        queue_ns += t2 - t1;
+    }
+    for (int i = 0; i < QUEUE_DEPTH; i++) {
+        result.checksum += out[i];
+    }
+    result.convert_ns = (double)convert_ns / SAMPLES;
+    result.queue_ns = (double)queue_ns / SAMPLES;
+    vQueueDelete(euler_queue);
+    vQueueDelete(accel_queue);
+    return result;
+}
+
+}
+
+int main()
+{
+    makeSamples();
+    const Result after = runRaw();
+    const Result before = runDouble<double>();
+    const Result before_soft = runDouble<__float128>();
+    printf("per sample (3 euler angles + linear accel z), %d samples\n", SAMPLES);
+    printf("  %-22s %10s %10s %12s\n", "", "convert ns", "queue ns", "queue bytes");
+    printf("  %-22s %10.1f %10.1f %12zu\n", "double (before)", before.convert_ns, before.queue_ns,
+        sizeof(EulerReal<double>) + sizeof(double));
+    printf("  %-22s %10.1f %10s %12s\n", "soft-float (before)", before_soft.convert_ns, "-", "-");
+    printf("  %-22s %10.1f %10.1f %12zu\n", "raw s16 (after)", after.convert_ns, after.queue_ns,
+        sizeof(bno055_euler_t) + sizeof(s16));
+    HOST_CHECK(fabsf(before.checksum - after.checksum) <= 1e-3f * fabsf(before.checksum));
+    HOST_CHECK(fabsf(before_soft.checksum - after.checksum) <= 1e-3f * fabsf(before.checksum));
+    return 0;
+}
@@ -0,0 +1,167 @@
+// 生产者与消费者分处两个线程时每个样本的传递开销：SpscRing 对比 FreeRTOS 队列
+// 队列按样本入队是 user-003 之前采集任务的做法，按块入队是队列能做到的最好情况；环形缓冲区按小批写入、按水位线整块唤醒
+// 主机上的队列替身是互斥锁加条件变量，与 FreeRTOS 在临界区里拷贝的开销量级相近，任务切换的开销两边都不含
+#include "HostTest.hpp"
+#include "SpscRing.hpp"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include <thread>
+
+namespace {
+
+constexpr uint32_t SAMPLES = 1 << 20;
+constexpr int BLOCK = 128; // 与 DSP_BLOCK_SAMPLES 相同
+constexpr int PRODUCER_BATCH = 4; // 采集任务每次读出的样本数
+
+struct Sample {
+    int16_t x;
+    int16_t y;
+    int16_t z;
+};
+
+Sample makeSample(uint32_t i)
+{
+    return { (int16_t)i, (int16_t)(i >> 3), (int16_t)(i * 7) };
+}
+
+// 消费者侧的校验和，两种传递方式都应得到同样的值
+struct Checksum {
+    uint64_t sum = 0;
+    void add(const Sample& s) { sum = sum * 31 + (uint16_t)s.x + (uint16_t)s.y + (uint16_t)s.z; }
+};
+
+template <typename Producer, typename Consumer>
+double nsPerSample(Producer produce, Consumer consume, uint64_t* checksum)
+{
+    const int64_t start = hostNowNs();
+    std::thread producer(produce);
+    *checksum = consume();
+    producer.join();
+    return (double)(hostNowNs() - start) / SAMPLES;
+}
+
+uint64_t expectedChecksum()
+{
+    Checksum checksum;
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        checksum.add(makeSample(i));
+    }
+    return checksum.sum;
+}
+
+double queuePerSample(uint64_t* checksum)
+{
+    QueueHandle_t queue = xQueueCreate(2 * BLOCK, sizeof(Sample));
+    const double ns = nsPerSample(
+        [&] {
+            for (uint32_t i = 0; i < SAMPLES; i++) {
+                const Sample s = makeSample(i);
+                xQueueSend(queue, &s, portMAX_DELAY);
+            }
+        },
+        [&] {
+            Checksum sum;
+            Sample s;
+            for (uint32_t i = 0; i < SAMPLES; i++) {
+                xQueueReceive(queue, &s, portMAX_DELAY);
+                sum.add(s);
+            }
+            return sum.sum;
+        },
+        checksum);
+    vQueueDelete(queue);
+    return ns;
+}
+
+double queuePerBlock(uint64_t* checksum)
+{
+    struct Block {
+        Sample samples[BLOCK];
+    };
+    QueueHandle_t queue = xQueueCreate(2, sizeof(Block));
+    const double ns = nsPerSample(
+        [&] {
+            Block block;
+            for (uint32_t i = 0; i < SAMPLES; i++) {
+                block.samples[i % BLOCK] = makeSample(i);
+                if (i % BLOCK == BLOCK - 1) {
+                    xQueueSend(queue, &block, portMAX_DELAY);
+                }
+            }
+        },
+        [&] {
+            Checksum sum;
+            Block block;
+            for (uint32_t b = 0; b < SAMPLES / BLOCK; b++) {
+                xQueueReceive(queue, &block, portMAX_DELAY);
+                for (int i = 0; i < BLOCK; i++) {
+                    sum.add(block.samples[i]);
+                }
+            }
+            return sum.sum;
+        },
+        checksum);
+    vQueueDelete(queue);
+    return ns;
+}
+
+double ringPerBlock(uint64_t* checksum)
+{
+    static SpscRing<Sample, 4 * BLOCK> ring;
+    std::atomic<bool> registered { false };
+    const double ns = nsPerSample(
+        [&] {
+            while (!registered.load()) {
+                std::this_thread::yield();
+            }
+            Sample batch[PRODUCER_BATCH];
+            for (uint32_t i = 0; i < SAMPLES; i += PRODUCER_BATCH) {
+                for (int k = 0; k < PRODUCER_BATCH; k++) {
+                    batch[k] = makeSample(i + k);
+                }
+                for (size_t written = 0; written < PRODUCER_BATCH;) {
+                    written += ring.push_n(batch + written, PRODUCER_BATCH - written);
+                    if (written < PRODUCER_BATCH) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        },
+        [&] {
+            ring.set_consumer(xTaskGetCurrentTaskHandle(), BLOCK);
+            registered.store(true);
+            Checksum sum;
+            Sample block[BLOCK];
+            for (uint32_t b = 0; b < SAMPLES / BLOCK; b++) {
+                ring.wait(portMAX_DELAY);
+                ring.pop_n(block, BLOCK);
+                for (int i = 0; i < BLOCK; i++) {
+                    sum.add(block[i]);
+                }
+            }
+            return sum.sum;
+        },
+        checksum);
+    return ns;
+}
+
+} // namespace
+
+int main()
+{
+    static_assert(SAMPLES % BLOCK == 0 && BLOCK % PRODUCER_BATCH == 0, "block sizes must divide the sample count");
+    const uint64_t expected = expectedChecksum();
+    uint64_t checksum;
+    const double queue_sample = queuePerSample(&checksum);
+    HOST_CHECK(checksum == expected);
+    const double queue_block = queuePerBlock(&checksum);
+    HOST_CHECK(checksum == expected);
+    const double ring_block = ringPerBlock(&checksum);
+    HOST_CHECK(checksum == expected);
+
+    printf("ns per sample, %u samples of %d bytes, producer thread -> consumer thread\n", (unsigned)SAMPLES, (int)sizeof(Sample));
+    printf("  %-36s %8.1f\n", "xQueue, one sample per item", queue_sample);
+    printf("  %-36s %8.1f\n", "xQueue, one block per item", queue_block);
+    printf("  %-36s %8.1f\n", "SpscRing, push_n 4, wake per block", ring_block);
+    return 0;
+}
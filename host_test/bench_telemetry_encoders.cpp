@@ -0,0 +1,185 @@
+// 遥测编码器的每条记录字节数与编码耗时：二进制格式 (packed / delta / XOR) 对比 JSON 编码器与 snprintf 基线
+// 按 BatchPublisher 的 begin/encode/end 顺序编一整批，字节数含批头与分隔符，均摊到每条记录
+// snprintf 基线输出与 JSON 编码器相同的文本，按 JSON 数组的方式在记录之间加逗号、首尾加方括号
+#include "HostTest.hpp"
+#include "EulerEncoder.hpp"
+#include "FeaturesEncoder.hpp"
+#include <inttypes.h>
+
+namespace {
+
+constexpr int EULER_BATCH = 100; // 100Hz 下一秒一批
+constexpr int FEATURES_BATCH = 32; // 四个轴各 8 段
+constexpr int ROUNDS = 2000;
+constexpr int BATCH_BYTES = 16 * 1024;
+static_assert(SPECTRAL_TOP_K == 4 && SPECTRAL_MAX_BANDS == 4, "snprintf baseline below spells out 4 peaks and 4 bands");
+
+uint8_t batch[BATCH_BYTES];
+EulerRecord euler_records[EULER_BATCH];
+SpectralFeatures features_records[FEATURES_BATCH];
+
+// 10ms 采样周期加几十 µs 抖动，姿态角缓慢变化
+void makeEulerRecords(int round)
+{
+    for (int i = 0; i < EULER_BATCH; i++) {
+        const int n = round * EULER_BATCH + i;
+        euler_records[i].timestamp_us = 1700000000000000LL + (int64_t)n * 10000 + (n * 37) % 90 - 45;
+        euler_records[i].euler.r = (int16_t)(200 + (n * 3) % 400 - 200);
+        euler_records[i].euler.p = (int16_t)(-(n * 5) % 300);
+        euler_records[i].euler.h = (int16_t)((n * 7) % 5760);
+    }
+}
+
+// 同一段四个轴时刻相同，主频与频带能量随段缓慢漂移
+void makeFeaturesRecords(int round)
+{
+    for (int i = 0; i < FEATURES_BATCH; i++) {
+        const int axis = i % XorFeaturesLayout::AXES;
+        const int segment = round * (FEATURES_BATCH / XorFeaturesLayout::AXES) + i / XorFeaturesLayout::AXES;
+        SpectralFeatures& f = features_records[i];
+        f = {};
+        f.timestamp_us = 1700000000000000LL + (int64_t)segment * 512000;
+        f.axis = axis;
+        f.dominant_freq_hz = 49.8f + 0.01f * (segment % 5);
+        f.dominant_psd = 1.5e-3f * (axis + 1) * (1.0f + 0.001f * (segment % 100));
+        for (int k = 0; k < SPECTRAL_TOP_K; k++) {
+            f.peaks[k] = { 49.8f * (k + 1), f.dominant_psd / (k + 1) };
+            f.envelope_peaks[k] = { 12.25f * (k + 1), 2e-5f * (k + 1) };
+        }
+        for (int b = 0; b < SPECTRAL_MAX_BANDS; b++) {
+            f.band_energy[b] = 1e-4f * (b + 1) + 1e-7f * (segment % 100);
+        }
+        f.rms = 0.02f + 0.0001f * axis;
+        f.crest_factor = 1.414f + 0.001f * (segment % 7);
+        f.centroid_hz = 120.0f + axis;
+        f.kurtosis = 1.5f + 0.01f * (segment % 2);
+        f.anomaly_score = 0.1f * (segment % 9);
+        f.anomaly_peak_z = -0.5f * axis;
+    }
+}
+
+template <typename Record>
+int encodeBatch(TelemetryEncoder<Record>& encoder, const Record* records, int count)
+{
+    int len = encoder.begin(batch, BATCH_BYTES);
+    HOST_CHECK(len > 0);
+    for (int i = 0; i < count; i++) {
+        const int n = encoder.encode(records[i], batch + len, BATCH_BYTES - len - encoder.trailerSize());
+        HOST_CHECK(n > 0);
+        len += n;
+    }
+    return len + encoder.end(batch, len, count);
+}
+
+// 与 JsonEulerEncoder 相同的记录文本
+int snprintfEuler(const EulerRecord& r, char* out, int capacity)
+{
+    const float scale = 1.0f / 16.0f;
+    return snprintf(out, capacity, "{\"t\":%" PRId64 ",\"roll\":%.2f,\"pitch\":%.2f,\"yaw\":%.2f}", r.timestamp_us / 1000,
+        r.euler.r * scale, r.euler.p * scale, r.euler.h * scale);
+}
+
+// 与 JsonFeaturesEncoder 相同的记录文本
+int snprintfFeatures(const SpectralFeatures& f, char* out, int capacity)
+{
+    return snprintf(out, capacity,
+        "{\"ts\":%" PRId64 ",\"axis\":%d,\"f0\":%.2f,\"p0\":%.3e,\"rms\":%.4f,\"crest\":%.2f,\"centroid\":%.2f,\"kurtosis\":%.2f,"
+        "\"score\":%.2f,\"peak_z\":%.2f,\"peaks\":[[%.2f,%.3e],[%.2f,%.3e],[%.2f,%.3e],[%.2f,%.3e]],"
+        "\"bands\":[%.3e,%.3e,%.3e,%.3e],\"env\":[[%.2f,%.3e],[%.2f,%.3e],[%.2f,%.3e],[%.2f,%.3e]]}",
+        f.timestamp_us, f.axis, f.dominant_freq_hz, f.dominant_psd, f.rms, f.crest_factor, f.centroid_hz, f.kurtosis,
+        f.anomaly_score, f.anomaly_peak_z,
+        f.peaks[0].freq_hz, f.peaks[0].psd, f.peaks[1].freq_hz, f.peaks[1].psd,
+        f.peaks[2].freq_hz, f.peaks[2].psd, f.peaks[3].freq_hz, f.peaks[3].psd,
+        f.band_energy[0], f.band_energy[1], f.band_energy[2], f.band_energy[3],
+        f.envelope_peaks[0].freq_hz, f.envelope_peaks[0].psd, f.envelope_peaks[1].freq_hz, f.envelope_peaks[1].psd,
+        f.envelope_peaks[2].freq_hz, f.envelope_peaks[2].psd, f.envelope_peaks[3].freq_hz, f.envelope_peaks[3].psd);
+}
+
+// snprintf 写成 JSON 数组，返回批次长度
+template <typename Record, typename Format>
+int snprintfBatch(const Record* records, int count, Format format)
+{
+    char* out = reinterpret_cast<char*>(batch);
+    int len = 0;
+    out[len++] = '[';
+    for (int i = 0; i < count; i++) {
+        if (i > 0) {
+            out[len++] = ',';
+        }
+        const int n = format(records[i], out + len, BATCH_BYTES - len - 1);
+        HOST_CHECK(n > 0 && n < BATCH_BYTES - len - 1);
+        len += n;
+    }
+    out[len++] = ']';
+    return len;
+}
+
+struct Result {
+    double bytes_per_record;
+    double ns_per_record;
+};
+
+// encode(round) 编一批并返回字节数；记录在计时之外生成，只计编码
+template <typename Make, typename Encode>
+Result measure(Make make, Encode encode, int batch_records)
+{
+    int64_t bytes = 0;
+    int64_t elapsed = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        make(round);
+        const int64_t start = hostNowNs();
+        bytes += encode();
+        elapsed += hostNowNs() - start;
+    }
+    hostKeep(bytes);
+    const double records = (double)ROUNDS * batch_records;
+    return { bytes / records, elapsed / records };
+}
+
+void printRow(const char* name, const Result& r, double baseline_bytes)
+{
+    printf("  %-20s %8.1f %8.2fx %10.1f\n", name, r.bytes_per_record, baseline_bytes / r.bytes_per_record, r.ns_per_record);
+}
+
+} // namespace
+
+int main()
+{
+    PackedEulerEncoder packed_euler;
+    DeltaEulerEncoder delta_euler;
+    JsonEulerEncoder json_euler;
+    XorFeaturesEncoder xor_features;
+    JsonFeaturesEncoder json_features;
+
+    const auto make_euler = [](int round) { makeEulerRecords(round); };
+    const auto make_features = [](int round) { makeFeaturesRecords(round); };
+    const Result euler_snprintf = measure(make_euler, [] { return snprintfBatch(euler_records, EULER_BATCH, snprintfEuler); }, EULER_BATCH);
+    const Result euler_json = measure(make_euler, [&] { return encodeBatch<EulerRecord>(json_euler, euler_records, EULER_BATCH); }, EULER_BATCH);
+    const Result euler_packed = measure(make_euler, [&] { return encodeBatch<EulerRecord>(packed_euler, euler_records, EULER_BATCH); }, EULER_BATCH);
+    const Result euler_delta = measure(make_euler, [&] { return encodeBatch<EulerRecord>(delta_euler, euler_records, EULER_BATCH); }, EULER_BATCH);
+    const Result features_snprintf = measure(make_features, [] {
+        return snprintfBatch(features_records, FEATURES_BATCH, snprintfFeatures);
+    }, FEATURES_BATCH);
+    const Result features_json = measure(make_features, [&] {
+        return encodeBatch<SpectralFeatures>(json_features, features_records, FEATURES_BATCH);
+    }, FEATURES_BATCH);
+    const Result features_xor = measure(make_features, [&] {
+        return encodeBatch<SpectralFeatures>(xor_features, features_records, FEATURES_BATCH);
+    }, FEATURES_BATCH);
+
+    // 二进制格式应比 JSON 小，JSON 编码器与 snprintf 输出文本相同，字节数只差批次外框
+    HOST_CHECK(euler_packed.bytes_per_record < euler_json.bytes_per_record);
+    HOST_CHECK(euler_delta.bytes_per_record < euler_packed.bytes_per_record);
+    HOST_CHECK(features_xor.bytes_per_record < features_json.bytes_per_record);
+
+    printf("per record, %d rounds, euler batches of %d, features batches of %d\n", ROUNDS, EULER_BATCH, FEATURES_BATCH);
+    printf("  %-20s %8s %9s %10s\n", "", "bytes", "vs json", "encode ns");
+    printRow("euler snprintf", euler_snprintf, euler_snprintf.bytes_per_record);
+    printRow("euler JsonWriter", euler_json, euler_snprintf.bytes_per_record);
+    printRow("euler packed", euler_packed, euler_snprintf.bytes_per_record);
+    printRow("euler delta", euler_delta, euler_snprintf.bytes_per_record);
+    printRow("features snprintf", features_snprintf, features_snprintf.bytes_per_record);
+    printRow("features JsonWriter", features_json, features_snprintf.bytes_per_record);
+    printRow("features xor", features_xor, features_snprintf.bytes_per_record);
+    return 0;
+}
@@ -0,0 +1,192 @@
+#include "esp_dsp.h"
+#include <math.h>
+#include <stdint.h>
+#include <utility>
+
+// 与 esp-dsp 一样，初始化时记下调用方提供的旋转因子表，之后的 FFT 都用这张表
+// 表按 dsps_gen_w_r2 生成后整体位反转，较小点数的 FFT 使用表的前一段
+namespace {
+
+float* fc32_table = nullptr;
+int fc32_table_size = 0;
+int16_t* sc16_table = nullptr;
+int sc16_table_size = 0;
+
+bool isPowerOfTwo(int n)
+{
+    return n > 0 && (n & (n - 1)) == 0;
+}
+
+template <typename T>
+void bitReverse(T* data, int N)
+{
+    int j = 0;
+    for (int i = 1; i < N - 1; i++) {
+        int k = N >> 1;
+        while (k <= j) {
+            j -= k;
+            k >>= 1;
+        }
+        j += k;
+        if (i < j) {
+            std::swap(data[i * 2 + 0], data[j * 2 + 0]);
+            std::swap(data[i * 2 + 1], data[j * 2 + 1]);
+        }
+    }
+}
+
+}
+
+esp_err_t dsps_fft2r_init_fc32(float* fft_table_buff, int table_size)
+{
+    if (fft_table_buff == nullptr || !isPowerOfTwo(table_size)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const float e = (float)(M_PI * 2.0 / table_size);
+    for (int i = 0; i < table_size / 2; i++) {
+        fft_table_buff[i * 2 + 0] = cosf(i * e);
+        fft_table_buff[i * 2 + 1] = sinf(i * e);
+    }
+    bitReverse(fft_table_buff, table_size / 2);
+    fc32_table = fft_table_buff;
+    fc32_table_size = table_size;
+    return ESP_OK;
+}
+
+esp_err_t dsps_fft2r_fc32(float* data, int N)
+{
+    if (!isPowerOfTwo(N) || N > fc32_table_size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    const float* w = fc32_table;
+    int ie = 1;
+    for (int N2 = N / 2; N2 > 0; N2 >>= 1) {
+        int ia = 0;
+        for (int j = 0; j < ie; j++) {
+            const float c = w[j * 2 + 0];
+            const float s = w[j * 2 + 1];
+            for (int i = 0; i < N2; i++) {
+                const int m = ia + N2;
+                const float m_re = c * data[m * 2 + 0] + s * data[m * 2 + 1];
+                const float m_im = c * data[m * 2 + 1] - s * data[m * 2 + 0];
+                data[m * 2 + 0] = data[ia * 2 + 0] - m_re;
+                data[m * 2 + 1] = data[ia * 2 + 1] - m_im;
+                data[ia * 2 + 0] += m_re;
+                data[ia * 2 + 1] += m_im;
+                ia++;
+            }
+            ia += N2;
+        }
+        ie <<= 1;
+    }
+    return ESP_OK;
+}
+
+esp_err_t dsps_bit_rev_fc32(float* data, int N)
+{
+    if (!isPowerOfTwo(N)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    bitReverse(data, N);
+    return ESP_OK;
+}
+
+esp_err_t dsps_fft2r_init_sc16(int16_t* fft_table_buff, int table_size)
+{
+    if (fft_table_buff == nullptr || !isPowerOfTwo(table_size)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const float e = (float)(M_PI * 2.0 / table_size);
+    for (int i = 0; i < table_size / 2; i++) {
+        fft_table_buff[i * 2 + 0] = (int16_t)(INT16_MAX * cosf(i * e));
+        fft_table_buff[i * 2 + 1] = (int16_t)(INT16_MAX * sinf(i * e));
+    }
+    bitReverse(fft_table_buff, table_size / 2);
+    sc16_table = fft_table_buff;
+    sc16_table_size = table_size;
+    return ESP_OK;
+}
+
+// 每级蝶形 (a ± m * w) / 2，Q15 乘积加 0x7fff 后右移 16 位，整个 FFT 结果缩小 N 倍
+esp_err_t dsps_fft2r_sc16(int16_t* data, int N)
+{
+    if (!isPowerOfTwo(N) || N > sc16_table_size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    const int16_t* w = sc16_table;
+    int ie = 1;
+    for (int N2 = N / 2; N2 > 0; N2 >>= 1) {
+        int ia = 0;
+        for (int j = 0; j < ie; j++) {
+            const int32_t c = w[j * 2 + 0];
+            const int32_t s = w[j * 2 + 1];
+            for (int i = 0; i < N2; i++) {
+                const int m = ia + N2;
+                const int32_t a_re = data[ia * 2 + 0];
+                const int32_t a_im = data[ia * 2 + 1];
+                const int32_t m_re = data[m * 2 + 0];
+                const int32_t m_im = data[m * 2 + 1];
+                const int32_t t_re = c * m_re + s * m_im;
+                const int32_t t_im = c * m_im - s * m_re;
+                data[m * 2 + 0] = (int16_t)((a_re * 0x7fff - t_re + 0x7fff) >> 16);
+                data[m * 2 + 1] = (int16_t)((a_im * 0x7fff - t_im + 0x7fff) >> 16);
+                data[ia * 2 + 0] = (int16_t)((a_re * 0x7fff + t_re + 0x7fff) >> 16);
+                data[ia * 2 + 1] = (int16_t)((a_im * 0x7fff + t_im + 0x7fff) >> 16);
+                ia++;
+            }
+            ia += N2;
+        }
+        ie <<= 1;
+    }
+    return ESP_OK;
+}
+
+esp_err_t dsps_bit_rev_sc16_ansi(int16_t* data, int N)
+{
+    if (!isPowerOfTwo(N)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    bitReverse(data, N);
+    return ESP_OK;
+}
+
+esp_err_t dsps_mul_f32(const float* input1, const float* input2, float* output, int len, int step1, int step2, int step_out)
+{
+    for (int i = 0; i < len; i++) {
+        output[i * step_out] = input1[i * step1] * input2[i * step2];
+    }
+    return ESP_OK;
+}
+
+esp_err_t dsps_mul_s16(const int16_t* input1, const int16_t* input2, int16_t* output, int len, int step1, int step2, int step_out, int shift)
+{
+    for (int i = 0; i < len; i++) {
+        const int32_t acc = (int32_t)input1[i * step1] * (int32_t)input2[i * step2];
+        output[i * step_out] = (int16_t)(acc >> shift);
+    }
+    return ESP_OK;
+}
+
+esp_err_t dsps_add_f32(const float* input1, const float* input2, float* output, int len, int step1, int step2, int step_out)
+{
+    for (int i = 0; i < len; i++) {
+        output[i * step_out] = input1[i * step1] + input2[i * step2];
+    }
+    return ESP_OK;
+}
+
+esp_err_t dsps_mulc_f32(const float* input, float* output, int len, float C, int step_in, int step_out)
+{
+    for (int i = 0; i < len; i++) {
+        output[i * step_out] = input[i * step_in] * C;
+    }
+    return ESP_OK;
+}
+
+void dsps_wind_hann_f32(float* window, int len)
+{
+    const float len_mult = 1.0f / (float)(len - 1);
+    for (int i = 0; i < len; i++) {
+        window[i] = 0.5f * (1 - cosf(i * 2 * (float)M_PI * len_mult));
+    }
+}
@@ -0,0 +1,8 @@
+#include "esp_timer.h"
+#include <chrono>
+
+int64_t esp_timer_get_time(void)
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
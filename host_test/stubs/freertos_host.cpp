@@ -0,0 +1,124 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+// 与 FreeRTOS 队列相同的语义：定长元素按值拷贝进环形存储，满时发送方、空时接收方最多等待 ticks 个 tick
+struct HostQueue {
+    std::mutex lock;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    std::vector<uint8_t> storage;
+    size_t item_size;
+    size_t length;
+    size_t head = 0;
+    size_t count = 0;
+};
+
+namespace {
+
+struct HostTask {
+    std::mutex lock;
+    std::condition_variable notified;
+    uint32_t count = 0;
+};
+
+thread_local HostTask current_task;
+
+// 等待 ready() 成立，portMAX_DELAY 一直等，其余按 1 tick = 1ms 超时
+template <typename Ready>
+bool waitFor(std::condition_variable& cv, std::unique_lock<std::mutex>& guard, TickType_t ticks, Ready ready)
+{
+    if (ticks == portMAX_DELAY) {
+        cv.wait(guard, ready);
+        return true;
+    }
+    return cv.wait_for(guard, std::chrono::milliseconds(ticks), ready);
+}
+
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    HostQueue* queue = new HostQueue;
+    queue->storage.resize((size_t)length * item_size);
+    queue->item_size = item_size;
+    queue->length = length;
+    return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    delete queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks_to_wait)
+{
+    std::unique_lock<std::mutex> guard(queue->lock);
+    if (!waitFor(queue->not_full, guard, ticks_to_wait, [&] { return queue->count < queue->length; })) {
+        return pdFALSE;
+    }
+    const size_t tail = (queue->head + queue->count) % queue->length;
+    memcpy(&queue->storage[tail * queue->item_size], item, queue->item_size);
+    queue->count++;
+    guard.unlock();
+    queue->not_empty.notify_one();
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks_to_wait)
+{
+    std::unique_lock<std::mutex> guard(queue->lock);
+    if (!waitFor(queue->not_empty, guard, ticks_to_wait, [&] { return queue->count > 0; })) {
+        return pdFALSE;
+    }
+    memcpy(item, &queue->storage[queue->head * queue->item_size], queue->item_size);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    guard.unlock();
+    queue->not_full.notify_one();
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    std::lock_guard<std::mutex> guard(queue->lock);
+    return (UBaseType_t)queue->count;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return &current_task;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    HostTask* target = static_cast<HostTask*>(task);
+    {
+        std::lock_guard<std::mutex> guard(target->lock);
+        target->count++;
+    }
+    target->notified.notify_one();
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+    std::unique_lock<std::mutex> guard(current_task.lock);
+    if (!waitFor(current_task.notified, guard, ticks_to_wait, [] { return current_task.count > 0; })) {
+        return 0;
+    }
+    const uint32_t count = current_task.count;
+    current_task.count = clear_on_exit ? 0 : count - 1;
+    return count;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
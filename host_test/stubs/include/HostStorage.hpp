@@ -0,0 +1,6 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+// 主机测试的 Storage 把文件放在内存里，测试可以直接检查写入的内容；不存在时返回 nullptr
+const std::vector<uint8_t>* hostStorageFile(const char* path);
@@ -0,0 +1,6 @@
+#pragma once
+// 主机测试只用到驱动头文件里的句柄类型，不访问总线；与 ESP-IDF 一样间接带入信号量类型
+#include "freertos/semphr.h"
+
+typedef struct i2c_master_dev_t* i2c_master_dev_handle_t;
+typedef struct i2c_master_bus_t* i2c_master_bus_handle_t;
@@ -0,0 +1,18 @@
+#pragma once
+// 主机测试用的 esp-dsp 子集，实现见 esp_dsp_host.cpp，与 esp-dsp 的 ANSI C 版本算法一致
+#include "esp_err.h"
+#include <stdint.h>
+
+esp_err_t dsps_fft2r_init_fc32(float* fft_table_buff, int table_size);
+esp_err_t dsps_fft2r_fc32(float* data, int N);
+esp_err_t dsps_bit_rev_fc32(float* data, int N);
+esp_err_t dsps_fft2r_init_sc16(int16_t* fft_table_buff, int table_size);
+esp_err_t dsps_fft2r_sc16(int16_t* data, int N);
+esp_err_t dsps_bit_rev_sc16_ansi(int16_t* data, int N);
+
+esp_err_t dsps_mul_f32(const float* input1, const float* input2, float* output, int len, int step1, int step2, int step_out);
+esp_err_t dsps_mul_s16(const int16_t* input1, const int16_t* input2, int16_t* output, int len, int step1, int step2, int step_out, int shift);
+esp_err_t dsps_add_f32(const float* input1, const float* input2, float* output, int len, int step1, int step2, int step_out);
+esp_err_t dsps_mulc_f32(const float* input, float* output, int len, float C, int step_in, int step_out);
+
+void dsps_wind_hann_f32(float* window, int len);
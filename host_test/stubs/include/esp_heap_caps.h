@@ -0,0 +1,31 @@
+#pragma once
+// 主机测试用的 heap_caps：忽略内存属性，按要求对齐
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+
+static inline void* heap_caps_malloc(size_t size, uint32_t caps)
+{
+    (void)caps;
+    return malloc(size);
+}
+
+static inline void* heap_caps_aligned_calloc(size_t alignment, size_t n, size_t size, uint32_t caps)
+{
+    (void)caps;
+    const size_t bytes = (n * size + alignment - 1) / alignment * alignment;
+    void* ptr = aligned_alloc(alignment, bytes);
+    if (ptr != NULL) {
+        memset(ptr, 0, bytes);
+    }
+    return ptr;
+}
+
+static inline void heap_caps_free(void* ptr)
+{
+    free(ptr);
+}
@@ -0,0 +1,21 @@
+#pragma once
+// 主机测试用的 esp_timer：只提供单调时钟，定时器回调不会被调用
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef void* esp_timer_handle_t;
+typedef void (*esp_timer_cb_t)(void* arg);
+typedef enum {
+    ESP_TIMER_TASK,
+    ESP_TIMER_ISR,
+} esp_timer_dispatch_t;
+typedef struct {
+    esp_timer_cb_t callback;
+    void* arg;
+    esp_timer_dispatch_t dispatch_method;
+    const char* name;
+    bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+int64_t esp_timer_get_time(void);
@@ -0,0 +1,5 @@
+#pragma once
+#include "queue.h"
+
+// 只提供句柄类型，主机测试不使用信号量
+typedef QueueHandle_t SemaphoreHandle_t;
@@ -0,0 +1,8 @@
+#pragma once
+#include "FreeRTOS.h"
+
+// 每个线程有一个隐式的任务句柄，只支持计数型任务通知
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait);
+void vTaskDelay(TickType_t ticks);
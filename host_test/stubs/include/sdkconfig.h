@@ -0,0 +1,2 @@
+#pragma once
+// 主机测试按没有 PSRAM 的配置编译 (DSP_FFT_MAX_SAMPLES = 1024)
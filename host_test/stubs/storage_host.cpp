@@ -0,0 +1,71 @@
+#include "Storage.hpp"
+#include "HostStorage.hpp"
+#include <map>
+#include <string>
+#include <string.h>
+
+// 与 Storage.cpp 相同的接口与返回值，文件内容放在内存里
+bool Storage::mounted = false;
+
+namespace {
+
+std::map<std::string, std::vector<uint8_t>> files;
+
+}
+
+const std::vector<uint8_t>* hostStorageFile(const char* path)
+{
+    auto it = files.find(path);
+    return it == files.end() ? nullptr : &it->second;
+}
+
+esp_err_t Storage::mount()
+{
+    mounted = true;
+    return ESP_OK;
+}
+
+esp_err_t Storage::writeFile(const char* path, const void* header, size_t header_size, const void* data, size_t data_size)
+{
+    return writeFile(path, header, header_size, &data, data_size, 1);
+}
+
+esp_err_t Storage::readFile(const char* path, void* header, size_t header_size, void* data, size_t data_size)
+{
+    return readFile(path, header, header_size, &data, data_size, 1);
+}
+
+esp_err_t Storage::writeFile(const char* path, const void* header, size_t header_size,
+    const void* const* parts, size_t part_size, int part_count)
+{
+    if (!mounted) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    std::vector<uint8_t> content(static_cast<const uint8_t*>(header), static_cast<const uint8_t*>(header) + header_size);
+    for (int i = 0; i < part_count; i++) {
+        const uint8_t* part = static_cast<const uint8_t*>(parts[i]);
+        content.insert(content.end(), part, part + part_size);
+    }
+    files[path] = std::move(content);
+    return ESP_OK;
+}
+
+esp_err_t Storage::readFile(const char* path, void* header, size_t header_size,
+    void* const* parts, size_t part_size, int part_count)
+{
+    if (!mounted) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    const std::vector<uint8_t>* content = hostStorageFile(path);
+    if (content == nullptr) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (content->size() < header_size + part_size * part_count) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(header, content->data(), header_size);
+    for (int i = 0; i < part_count; i++) {
+        memcpy(parts[i], content->data() + header_size + part_size * i, part_size);
+    }
+    return ESP_OK;
+}
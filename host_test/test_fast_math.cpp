@@ -0,0 +1,64 @@
+// fastLog2 / fastPowerDb 相对双精度 log10 的最大误差
+// 按 float 位模式等间隔取样，覆盖每个二进制阶的整个尾数区间
+// 全范围 1e-30 ~ 1e30 的误差主要来自 ±300 dB 处结果本身的 float 舍入；功率谱实际落在 PSD_FLOOR (1e-12) ~ 1e6
+#include "HostTest.hpp"
+#include "FastMath.hpp"
+#include <math.h>
+#include <string.h>
+
+namespace {
+
+constexpr uint32_t STRIDE = 61;
+
+struct Range {
+    float low;
+    float high;
+    double max_log2_error;
+    double max_db_error;
+};
+
+const Range RANGES[] = {
+    { 1e-30f, 1e30f, 1e-5, 3.5e-5 },
+    { 1e-12f, 1e6f, 1e-5, 1.5e-5 },
+};
+
+uint32_t floatBits(float x)
+{
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+float bitsFloat(uint32_t bits)
+{
+    float x;
+    memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+}
+
+int main()
+{
+    for (const Range& range : RANGES) {
+        double max_log2_error = 0;
+        double max_db_error = 0;
+        const uint32_t last = floatBits(range.high);
+        for (uint32_t bits = floatBits(range.low); bits <= last; bits += STRIDE) {
+            const float x = bitsFloat(bits);
+            max_log2_error = fmax(max_log2_error, fabs(fastLog2(x) - log2((double)x)));
+            max_db_error = fmax(max_db_error, fabs(fastPowerDb(x) - 10 * log10((double)x)));
+        }
+        printf("%g ~ %g: fastLog2 max error %.3g, fastPowerDb max error %.3g dB\n",
+            range.low, range.high, max_log2_error, max_db_error);
+        HOST_CHECK(max_log2_error <= range.max_log2_error);
+        HOST_CHECK(max_db_error <= range.max_db_error);
+    }
+
+    // 2 的整数次幂正好落在多项式的零点上
+    for (int e = -100; e <= 100; e++) {
+        HOST_CHECK(fastLog2(ldexpf(1.0f, e)) == (float)e);
+    }
+    HOST_CHECK(fastLog2(0.0f) == -127.0f);
+    return 0;
+}
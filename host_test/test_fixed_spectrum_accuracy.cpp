@@ -0,0 +1,153 @@
+// 定点频谱 (FixedSpectrum，Q15 窗 + sc16 FFT) 相对浮点处理链的精度
+// 同一段原始 s16 样本分别走定点路径与浮点 Pipeline<Window, RealFFT, Periodogram>，比较两者的单边功率谱密度：
+//   SNR：10*log10(sum(P_float) / sum((sqrt(P_fixed) - sqrt(P_float))^2))，按幅度谱计算的误差功率
+//   峰值：浮点谱的前 SPECTRAL_TOP_K 个峰在定点谱中找到同一频点（插值后相差不超过半个频点）
+// 输入为 BNO055 加速度原始值（1 LSB = 0.01 m/s^2，不超过 12 位），使用 DSP_Q15_INPUT_SHIFT 与 Q15 窗
+#include "HostTest.hpp"
+#include "APPConfig.h"
+#include "DSPPipeline.hpp"
+#include "FixedSpectrum.hpp"
+#include "SpectralFeatures.hpp"
+#include <inttypes.h>
+#include <math.h>
+#include <string.h>
+
+namespace {
+
+constexpr int MAX_N = DSP_FFT_MAX_SAMPLES;
+constexpr uint32_t SAMPLE_RATE_HZ = VIBRATION_SAMPLE_RATE_HZ;
+constexpr float SAMPLE_SCALE = 1.0f / 100.0f;
+
+struct Tone {
+    float amplitude; // LSB
+    float freq_hz;
+};
+
+struct Signal {
+    const char* name;
+    Tone tones[2];
+    float noise_rms; // LSB
+    float offset; // LSB
+    float min_snr_db;
+    bool check_peaks; // 纯噪声没有确定的峰
+};
+
+const Signal SIGNALS[] = {
+    { "tone 1000 LSB + DC", { { 1000, 123.4f }, { 0, 0 } }, 0, 200, 40, true },
+    { "tones 2000/20 LSB", { { 2000, 87.9f }, { 20, 311.2f } }, 0, 0, 40, true },
+    { "tone 500 + noise 50", { { 500, 201.7f }, { 0, 0 } }, 50, 0, 30, true },
+    { "noise 300 LSB", { { 0, 0 }, { 0, 0 } }, 300, 0, 30, false },
+    { "tone 8 + noise 2 LSB", { { 8, 45.3f }, { 0, 0 } }, 2, 0, 10, true },
+};
+
+uint32_t seed = 12345;
+
+float uniform()
+{
+    seed = seed * 1664525u + 1013904223u;
+    return ((seed >> 8) + 0.5f) / (float)(1 << 24);
+}
+
+float gaussian()
+{
+    return sqrtf(-2 * logf(uniform())) * cosf(2 * (float)M_PI * uniform());
+}
+
+using AxisPipeline = Pipeline<Window<HannShape, MAX_N>, RealFFT<MAX_N>, Periodogram<MAX_N>>;
+AxisPipeline pipeline;
+FixedSpectrum<MAX_N> fixed;
+int16_t raw[MAX_N];
+float samples[MAX_N];
+alignas(16) int16_t work[MAX_N];
+float scratch[MAX_N];
+float fixed_psd[MAX_N / 2];
+
+struct Result {
+    float snr_db;
+    int peaks_matched;
+    int peaks;
+};
+
+Result compare(const Signal& signal, int n)
+{
+    for (int i = 0; i < n; i++) {
+        float v = signal.offset + signal.noise_rms * gaussian();
+        for (const Tone& tone : signal.tones) {
+            v += tone.amplitude * sinf(2 * (float)M_PI * tone.freq_hz * i / SAMPLE_RATE_HZ);
+        }
+        raw[i] = (int16_t)lrintf(fminf(fmaxf(v, -32768.0f), 32767.0f));
+    }
+    // 环形历史从中间开始，覆盖分两段加窗的情况
+    const int start = n / 3;
+    int16_t ring[MAX_N];
+    for (int i = 0; i < n; i++) {
+        ring[(start + i) % n] = raw[i];
+        samples[(start + i) % n] = raw[i] * SAMPLE_SCALE;
+    }
+
+    PipelineContext ctx = { SAMPLE_RATE_HZ, n, 0 };
+    HOST_CHECK(pipeline.init(ctx) == ESP_OK);
+    const float* float_psd = pipeline.run(RingInput { samples, start });
+    HOST_CHECK(fixed.init(SAMPLE_RATE_HZ, n, SAMPLE_SCALE, scratch) == ESP_OK);
+    fixed.window(ring, start, work);
+    fixed.transform(work);
+    fixed.power(work, fixed_psd);
+
+    const int bins = n / 2;
+    double signal_power = 0;
+    double error_power = 0;
+    for (int i = 0; i < bins; i++) {
+        const double d = sqrt((double)fixed_psd[i]) - sqrt((double)float_psd[i]);
+        signal_power += float_psd[i];
+        error_power += d * d;
+    }
+    Result result = {};
+    result.snr_db = (float)(10 * log10(signal_power / (error_power + 1e-30)));
+
+    const float df = (float)SAMPLE_RATE_HZ / n;
+    SpectralFeatures::Peak float_peaks[SPECTRAL_TOP_K];
+    SpectralFeatures::Peak fixed_peaks[SPECTRAL_TOP_K];
+    SpectralFeatureExtractor::findPeaks(float_psd, bins, df, float_peaks);
+    SpectralFeatureExtractor::findPeaks(fixed_psd, bins, df, fixed_peaks);
+    for (int tone = 0; tone < 2; tone++) {
+        if (signal.tones[tone].amplitude == 0) {
+            continue;
+        }
+        result.peaks++;
+        // 浮点谱中对应这个音调的峰，在定点谱的峰里找同一频点
+        for (const auto& want : float_peaks) {
+            if (fabsf(want.freq_hz - signal.tones[tone].freq_hz) > df) {
+                continue;
+            }
+            for (const auto& got : fixed_peaks) {
+                if (got.psd > 0 && fabsf(got.freq_hz - want.freq_hz) <= 0.5f * df) {
+                    result.peaks_matched++;
+                    break;
+                }
+            }
+            break;
+        }
+    }
+    return result;
+}
+
+}
+
+int main()
+{
+    printf("fixed-point (sc16, Q15 window, input shift %d) vs float spectrum, fs %" PRIu32 "Hz\n",
+        DSP_Q15_INPUT_SHIFT, SAMPLE_RATE_HZ);
+    printf("  %-22s %6s %9s %7s\n", "signal", "points", "SNR dB", "peaks");
+    bool ok = true;
+    const int sizes[] = { DSP_FFT_MIN_SAMPLES, N_SAMPLES, DSP_FFT_MAX_SAMPLES };
+    for (const Signal& signal : SIGNALS) {
+        for (int n : sizes) {
+            const Result result = compare(signal, n);
+            printf("  %-22s %6d %9.1f %4d/%d\n", signal.name, n, result.snr_db, result.peaks_matched, result.peaks);
+            ok = ok && result.snr_db >= signal.min_snr_db;
+            ok = ok && (!signal.check_peaks || result.peaks_matched == result.peaks);
+        }
+    }
+    HOST_CHECK(ok);
+    return 0;
+}
@@ -0,0 +1,205 @@
+// JsonWriter 与 printf 的逐字对比：欧拉角原始计数、定点小数、科学计数、64 位整数与负零
+// 科学计数只有需要按超过 10^±10 缩放时允许末位差 1，其余都要求完全一致
+
+#include "HostTest.hpp"
+#include "JsonWriter.hpp"
+#include <inttypes.h>
+#include <math.h>
+#include <string.h>
+
+static uint32_t rng_state = 0x12345678;
+static uint32_t nextRandom()
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+// 二进制指数在 [min_exp, max_exp] 内均匀分布、尾数随机的 float，覆盖各个量级
+static float randomFloat(int min_exp, int max_exp)
+{
+    const int exponent = min_exp + (int)(nextRandom() % (uint32_t)(max_exp - min_exp + 1));
+    const float mantissa = 1.0f + (float)(nextRandom() & 0x7FFFFF) / 8388608.0f;
+    const float value = ldexpf(mantissa, exponent);
+    return (nextRandom() & 1) ? -value : value;
+}
+
+// 在 buf 里运行一段写入，返回以 '\0' 结尾的结果
+template <typename Write>
+static const char* written(char* buf, int capacity, Write write)
+{
+    JsonWriter writer(buf, capacity - 1);
+    write(writer);
+    const int len = writer.finish();
+    HOST_CHECK(len >= 0);
+    buf[len] = '\0';
+    return buf;
+}
+
+static void checkSame(const char* actual, const char* expected)
+{
+    if (strcmp(actual, expected) != 0) {
+        fprintf(stderr, "got %s, printf gives %s\n", actual, expected);
+        HOST_CHECK(false);
+    }
+}
+
+static void testCounts()
+{
+    char actual[32];
+    char expected[32];
+    for (int decimals = 0; decimals <= JsonWriter::MAX_COUNTS_PRECISION; decimals++) {
+        for (int32_t counts = INT16_MIN; counts <= INT16_MAX; counts++) {
+            written(actual, sizeof(actual), [&](JsonWriter& w) { w.putCounts<16>(counts, decimals); });
+            snprintf(expected, sizeof(expected), "%.*f", decimals, counts / 16.0f);
+            checkSame(actual, expected);
+        }
+    }
+    // 非 2 的幂的除数，BNO055 加速度 100 LSB/(m/s²)
+    for (int32_t counts = INT16_MIN; counts <= INT16_MAX; counts += 7) {
+        written(actual, sizeof(actual), [&](JsonWriter& w) { w.putCounts<100>(counts, 3); });
+        snprintf(expected, sizeof(expected), "%.3f", counts / 100.0);
+        checkSame(actual, expected);
+    }
+}
+
+static void testFixed()
+{
+    char actual[64];
+    char expected[64];
+    int checked = 0;
+    for (int i = 0; i < 2000000; i++) {
+        const int decimals = i % (JsonWriter::MAX_PRECISION + 1);
+        const float value = randomFloat(-30, 26);
+        written(actual, sizeof(actual), [&](JsonWriter& w) { w.putFixed(value, decimals); });
+        if (fabsf(value) * powf(10.0f, decimals) < 8388608.0f) {
+            snprintf(expected, sizeof(expected), "%.*f", decimals, value);
+        } else {
+            snprintf(expected, sizeof(expected), "%.*e", decimals, value); // 超出 2^23 个最小单位改用科学计数
+        }
+        checkSame(actual, expected);
+        checked++;
+    }
+    // 1/16 度这类二进制小数恰好落在一半上，printf 舍入到偶数
+    for (int n = -4000; n <= 4000; n++) {
+        const float value = n / 8.0f;
+        written(actual, sizeof(actual), [&](JsonWriter& w) { w.putFixed(value, 2); });
+        snprintf(expected, sizeof(expected), "%.2f", value);
+        checkSame(actual, expected);
+    }
+    printf("fixed: %d random values match printf\n", checked);
+}
+
+// 解析 "d.ddde±xx"，返回尾数的整数值与十进制指数
+static void parseScientific(const char* text, int64_t* mantissa, int* exponent)
+{
+    *mantissa = 0;
+    const char* p = text[0] == '-' ? text + 1 : text;
+    for (; *p != 'e'; p++) {
+        if (*p != '.') {
+            *mantissa = *mantissa * 10 + (*p - '0');
+        }
+    }
+    *exponent = atoi(p + 1);
+}
+
+static void testScientific()
+{
+    char actual[64];
+    char expected[64];
+    int exact_range = 0;
+    int wide_range = 0;
+    int wide_mismatch = 0;
+    for (int i = 0; i < 2000000; i++) {
+        const int digits = i % (JsonWriter::MAX_PRECISION + 1);
+        const float value = (i % 64 == 0) ? randomFloat(-149, -127) : randomFloat(-126, 127); // 包括非规格化数
+        written(actual, sizeof(actual), [&](JsonWriter& w) { w.putScientific(value, digits); });
+        snprintf(expected, sizeof(expected), "%.*e", digits, value);
+        int64_t expected_mantissa;
+        int expected_exponent;
+        parseScientific(expected, &expected_mantissa, &expected_exponent);
+        const int scaling = digits - expected_exponent;
+        if (scaling >= -10 && scaling <= 10) {
+            checkSame(actual, expected);
+            exact_range++;
+            continue;
+        }
+        wide_range++;
+        if (strcmp(actual, expected) == 0) {
+            continue;
+        }
+        // 末位差 1，进位到下一个指数时尾数是 10^digits
+        int64_t mantissa;
+        int exponent;
+        parseScientific(actual, &mantissa, &exponent);
+        const int64_t limit = (int64_t)llrint(pow(10.0, digits));
+        HOST_CHECK((actual[0] == '-') == (expected[0] == '-'));
+        HOST_CHECK((exponent == expected_exponent && llabs(mantissa - expected_mantissa) <= 1)
+            || (exponent == expected_exponent + 1 && mantissa == limit && expected_mantissa == limit * 10 - 1)
+            || (exponent == expected_exponent - 1 && mantissa == limit * 10 - 1 && expected_mantissa == limit));
+        wide_mismatch++;
+    }
+    printf("scientific: %d values within 10^+-10 scaling match printf; %d of %d beyond differ by one in the last digit\n",
+        exact_range, wide_mismatch, wide_range);
+}
+
+static void testSpecialValues()
+{
+    char actual[64];
+    const float negative_small = -0.001f;
+    checkSame(written(actual, sizeof(actual), [&](JsonWriter& w) { w.putFixed(negative_small, 2); }), "-0.00");
+    checkSame(written(actual, sizeof(actual), [&](JsonWriter& w) { w.putFixed(-0.0f, 2); }), "-0.00");
+    checkSame(written(actual, sizeof(actual), [&](JsonWriter& w) { w.putFixed(0.0f, 0); }), "0");
+    checkSame(written(actual, sizeof(actual), [&](JsonWriter& w) { w.putScientific(-0.0f, 3); }), "-0.000e+00");
+    checkSame(written(actual, sizeof(actual), [&](JsonWriter& w) { w.putScientific(9.9996f, 3); }), "1.000e+01");
+    checkSame(written(actual, sizeof(actual), [&](JsonWriter& w) { w.putCounts<16>(-1, 1); }), "-0.1");
+    checkSame(written(actual, sizeof(actual), [&](JsonWriter& w) { w.putFixed(NAN, 2); }), "null");
+    checkSame(written(actual, sizeof(actual), [&](JsonWriter& w) { w.putScientific(-INFINITY, 2); }), "null");
+
+    char expected[32];
+    const int64_t integers[] = { 0, -1, 4294967295LL, 4294967296LL, -4294967296LL, 1700000000123456LL, INT64_MAX, INT64_MIN };
+    for (int64_t value : integers) {
+        snprintf(expected, sizeof(expected), "%" PRId64, value);
+        checkSame(written(actual, sizeof(actual), [&](JsonWriter& w) { w.putInt(value); }), expected);
+    }
+    for (int i = 0; i < 100000; i++) {
+        const int64_t value = (int64_t)(((uint64_t)nextRandom() << 32) | nextRandom()) >> (nextRandom() % 64);
+        snprintf(expected, sizeof(expected), "%" PRId64, value);
+        checkSame(written(actual, sizeof(actual), [&](JsonWriter& w) { w.putInt(value); }), expected);
+    }
+}
+
+struct EulerJson {
+    int64_t t;
+    JsonCounts<16> roll;
+    JsonCounts<16> pitch;
+    JsonCounts<16> yaw;
+};
+static constexpr auto EULER_SCHEMA = jsonSchema<EulerJson>(
+    jsonField("t", &EulerJson::t),
+    jsonField<2>("roll", &EulerJson::roll),
+    jsonField<2>("pitch", &EulerJson::pitch),
+    jsonField<2>("yaw", &EulerJson::yaw));
+
+static void testSchema()
+{
+    const EulerJson euler = { 1700000000123LL, { -2881 }, { 8 }, { 5759 } };
+    char out[128];
+    const int len = EULER_SCHEMA.serialize(euler, out, sizeof(out));
+    HOST_CHECK(len > 0);
+    out[len] = '\0';
+    checkSame(out, "{\"t\":1700000000123,\"roll\":-180.06,\"pitch\":0.50,\"yaw\":359.94}");
+    // 放不下时返回 -1
+    HOST_CHECK(EULER_SCHEMA.serialize(euler, out, len - 1) == -1);
+}
+
+int main()
+{
+    testCounts();
+    testFixed();
+    testScientific();
+    testSpecialValues();
+    testSchema();
+    return 0;
+}
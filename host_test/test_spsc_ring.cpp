@@ -0,0 +1,117 @@
+// SpscRing 的单元测试：回绕与部分写入、跨线程的顺序，以及水位线唤醒
+// 唤醒测试里消费者每次都要等到生产者的通知，任何一次等待超过 STALL_MS 都算丢失唤醒
+
+#include "HostTest.hpp"
+#include "SpscRing.hpp"
+#include <thread>
+
+static constexpr int64_t STALL_MS = 200;
+
+static void testWraparound()
+{
+    SpscRing<int16_t, 8> ring;
+    const int16_t in[5] = { 1, 2, 3, 4, 5 };
+    int16_t out[8];
+    for (int k = 0; k < 100; k++) {
+        HOST_CHECK(ring.push_n(in, 5) == 5);
+        HOST_CHECK(ring.pop_n(out, 5) == 5);
+        for (int i = 0; i < 5; i++) {
+            HOST_CHECK(out[i] == in[i]);
+        }
+    }
+    // 空间不足时只写一部分，读出的内容跨过缓冲区末尾
+    HOST_CHECK(ring.push_n(in, 5) == 5);
+    HOST_CHECK(ring.push_n(in, 5) == 3);
+    HOST_CHECK(ring.size() == 8 && ring.free_space() == 0);
+    HOST_CHECK(!ring.push(in[0]));
+    HOST_CHECK(ring.pop_n(out, 8) == 8);
+    HOST_CHECK(out[0] == 1 && out[4] == 5 && out[5] == 1 && out[7] == 3);
+    int16_t value;
+    HOST_CHECK(!ring.pop(value));
+    HOST_CHECK(ring.size() == 0);
+}
+
+static void testOrdering()
+{
+    static constexpr uint32_t TOTAL = 1000000;
+    static SpscRing<uint32_t, 1024> ring;
+    std::thread producer([] {
+        uint32_t chunk[37];
+        for (uint32_t next = 0; next < TOTAL;) {
+            const uint32_t count = (TOTAL - next < 37) ? TOTAL - next : 1 + next % 37;
+            for (uint32_t i = 0; i < count; i++) {
+                chunk[i] = next + i;
+            }
+            const size_t written = ring.push_n(chunk, count);
+            next += written;
+            if (written == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    uint32_t out[64];
+    for (uint32_t expected = 0; expected < TOTAL;) {
+        const size_t count = ring.pop_n(out, 64);
+        for (size_t i = 0; i < count; i++) {
+            HOST_CHECK(out[i] == expected + i);
+        }
+        expected += count;
+    }
+    producer.join();
+    HOST_CHECK(ring.size() == 0);
+}
+
+// 消费者每次等满一个水位线再取走整块；生产者按不等长的小批写入，没有空间时让出 CPU
+static void testWatermarkWakeup()
+{
+    static constexpr size_t WATERMARK = 64;
+    static constexpr uint32_t BLOCKS = 20000;
+    static SpscRing<uint32_t, 256> ring;
+    ring.set_consumer(xTaskGetCurrentTaskHandle(), WATERMARK);
+    std::thread producer([] {
+        uint32_t chunk[7];
+        for (uint32_t next = 0; next < BLOCKS * WATERMARK;) {
+            const uint32_t count = (BLOCKS * WATERMARK - next < 7) ? BLOCKS * WATERMARK - next : 1 + next % 7;
+            for (uint32_t i = 0; i < count; i++) {
+                chunk[i] = next + i;
+            }
+            const size_t written = ring.push_n(chunk, count);
+            next += written;
+            if (written == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    uint32_t block[WATERMARK];
+    uint32_t expected = 0;
+    int stalls = 0;
+    for (uint32_t b = 0; b < BLOCKS; b++) {
+        const int64_t start = hostNowNs();
+        HOST_CHECK(ring.wait(pdMS_TO_TICKS(5000)));
+        if (hostNowNs() - start > STALL_MS * 1000000) {
+            stalls++;
+        }
+        HOST_CHECK(ring.pop_n(block, WATERMARK) == WATERMARK);
+        for (size_t i = 0; i < WATERMARK; i++) {
+            HOST_CHECK(block[i] == expected++);
+        }
+    }
+    producer.join();
+    printf("watermark wakeup: %u blocks, %d stalled waits\n", (unsigned)BLOCKS, stalls);
+    HOST_CHECK(stalls == 0);
+
+    // 不到水位线时等待超时返回 false，达到后立即返回 true
+    const uint32_t partial[WATERMARK] = {};
+    HOST_CHECK(ring.push_n(partial, WATERMARK - 1) == WATERMARK - 1);
+    HOST_CHECK(!ring.wait(pdMS_TO_TICKS(10)));
+    HOST_CHECK(ring.push(0));
+    HOST_CHECK(ring.wait(0));
+}
+
+int main()
+{
+    testWraparound();
+    testOrdering();
+    testWatermarkWakeup();
+    return 0;
+}
@@ -0,0 +1,155 @@
+// 二进制遥测格式的往返测试：设备端编码器写出的批次经 TelemetryDecoder.hpp 解码后应还原每条记录
+// 姿态时间戳取采样时刻（10ms 采样周期加几十 µs 抖动），解码结果按毫秒比较，第一条按微秒比较
+// 特征记录四个轴交替出现，时间戳与浮点字段都应逐位还原
+
+#include "HostTest.hpp"
+#include "EulerEncoder.hpp"
+#include "FeaturesEncoder.hpp"
+#include "TelemetryDecoder.hpp"
+#include <string.h>
+
+static constexpr int RECORDS = 200;
+static constexpr int BATCH_BYTES = 4096;
+
+// 编码一批：与 BatchPublisher 相同的 begin/encode/end 顺序，返回批次长度
+template <typename Record>
+static int encodeBatch(TelemetryEncoder<Record>& encoder, const Record* records, int count, uint8_t* batch, int capacity)
+{
+    int len = encoder.begin(batch, capacity);
+    HOST_CHECK(len > 0);
+    for (int i = 0; i < count; i++) {
+        const int n = encoder.encode(records[i], batch + len, capacity - len - encoder.trailerSize());
+        HOST_CHECK(n > 0);
+        len += n;
+    }
+    return len + encoder.end(batch, len, count);
+}
+
+static void makeEulerRecords(EulerRecord* records, int count)
+{
+    for (int i = 0; i < count; i++) {
+        const int jitter_us = (i * 37) % 90 - 45;
+        records[i].timestamp_us = 5000123 + (int64_t)i * 10000 + jitter_us;
+        records[i].euler.r = (int16_t)(i * 3 - 200);
+        records[i].euler.p = (int16_t)(-i * 5);
+        records[i].euler.h = (int16_t)((5740 + i * 7) % 5760); // 航向越过 360° (5760) 后回到 0
+    }
+}
+
+static void checkEuler(const EulerRecord* expected, const TelemetryEuler* decoded, int count)
+{
+    HOST_CHECK(decoded[0].timestamp_us == expected[0].timestamp_us);
+    for (int i = 0; i < count; i++) {
+        HOST_CHECK(decoded[i].timestamp_us / 1000 == expected[i].timestamp_us / 1000);
+        HOST_CHECK(decoded[i].roll == expected[i].euler.r);
+        HOST_CHECK(decoded[i].pitch == expected[i].euler.p);
+        HOST_CHECK(decoded[i].yaw == expected[i].euler.h);
+    }
+}
+
+static void testPackedEuler()
+{
+    static EulerRecord records[RECORDS];
+    static TelemetryEuler decoded[RECORDS];
+    static uint8_t batch[BATCH_BYTES];
+    makeEulerRecords(records, RECORDS);
+    PackedEulerEncoder encoder;
+    const int len = encodeBatch<EulerRecord>(encoder, records, RECORDS, batch, sizeof(batch));
+    HOST_CHECK(len == (int)(sizeof(TelemetryBatchHeader) + RECORDS * sizeof(PackedEulerSample)));
+    HOST_CHECK(TelemetryDecoder::decodePackedEuler(batch, len, decoded, RECORDS) == RECORDS);
+    checkEuler(records, decoded, RECORDS);
+
+    // 截断、容量不足与错误的格式编号都应拒绝
+    HOST_CHECK(TelemetryDecoder::decodePackedEuler(batch, len - 1, decoded, RECORDS) < 0);
+    HOST_CHECK(TelemetryDecoder::decodePackedEuler(batch, len, decoded, RECORDS - 1) < 0);
+    batch[3] = TELEMETRY_SCHEMA_EULER_DELTA;
+    HOST_CHECK(TelemetryDecoder::decodePackedEuler(batch, len, decoded, RECORDS) < 0);
+
+    // 时间差超出 uint16 毫秒时这一条不能接在本批后面，编码器状态不变
+    encoder.begin(batch, sizeof(batch));
+    HOST_CHECK(encoder.encode(records[0], batch, sizeof(batch)) > 0);
+    EulerRecord late = records[1];
+    late.timestamp_us = records[0].timestamp_us + 70000000;
+    HOST_CHECK(encoder.encode(late, batch, sizeof(batch)) < 0);
+    HOST_CHECK(encoder.encode(records[1], batch, sizeof(batch)) > 0);
+    printf("packed euler: %d records in %d bytes\n", RECORDS, len);
+}
+
+static void testDeltaEuler()
+{
+    static EulerRecord records[RECORDS];
+    static TelemetryEuler decoded[RECORDS];
+    static uint8_t batch[BATCH_BYTES];
+    makeEulerRecords(records, RECORDS);
+    DeltaEulerEncoder encoder;
+    const int len = encodeBatch<EulerRecord>(encoder, records, RECORDS, batch, sizeof(batch));
+    HOST_CHECK(TelemetryDecoder::decodeDeltaEuler(batch, len, decoded, RECORDS) == RECORDS);
+    checkEuler(records, decoded, RECORDS);
+    HOST_CHECK(TelemetryDecoder::decodeDeltaEuler(batch, len - 1, decoded, RECORDS) < 0);
+    HOST_CHECK(TelemetryDecoder::decodePackedEuler(batch, len, decoded, RECORDS) < 0);
+
+    // 同一批再编码一次，编码器在 begin 时清除差分状态，两次输出应完全相同
+    static uint8_t again[BATCH_BYTES];
+    HOST_CHECK(encodeBatch<EulerRecord>(encoder, records, RECORDS, again, sizeof(again)) == len);
+    HOST_CHECK(memcmp(batch, again, len) == 0);
+    printf("delta euler: %d records in %d bytes\n", RECORDS, len);
+}
+
+static void makeFeatures(SpectralFeatures* records, int count)
+{
+    for (int i = 0; i < count; i++) {
+        const int axis = i % XorFeaturesLayout::AXES;
+        const int segment = i / XorFeaturesLayout::AXES;
+        SpectralFeatures& f = records[i];
+        f = {};
+        f.timestamp_us = 7000000 + (int64_t)segment * 512000 + (segment % 3) * 17; // 同一段四个轴时刻相同
+        f.axis = axis;
+        f.dominant_freq_hz = 49.8f + 0.01f * (segment % 5);
+        f.dominant_psd = 1.5e-3f * (axis + 1) * (1.0f + 0.001f * segment);
+        for (int k = 0; k < SPECTRAL_TOP_K; k++) {
+            f.peaks[k] = { 49.8f * (k + 1), f.dominant_psd / (k + 1) };
+            f.envelope_peaks[k] = { 12.25f * (k + 1), (segment % 4 == 0) ? 0.0f : 2e-5f * (k + 1) };
+        }
+        for (int b = 0; b < SPECTRAL_MAX_BANDS; b++) {
+            f.band_energy[b] = 1e-4f * (b + 1) + 1e-7f * segment;
+        }
+        f.rms = 0.02f + 0.0001f * axis;
+        f.crest_factor = 1.414f + 0.001f * (segment % 7);
+        f.centroid_hz = 120.0f + axis;
+        f.kurtosis = 1.5f + 0.01f * (segment % 2);
+        f.anomaly_score = segment < 10 ? 0.0f : 0.1f * (segment % 9);
+        f.anomaly_peak_z = -0.5f * axis;
+    }
+}
+
+static void testXorFeatures()
+{
+    static constexpr int FEATURE_RECORDS = 64;
+    static SpectralFeatures records[FEATURE_RECORDS];
+    static SpectralFeatures decoded[FEATURE_RECORDS];
+    static uint8_t batch[BATCH_BYTES * 4];
+    makeFeatures(records, FEATURE_RECORDS);
+    XorFeaturesEncoder encoder;
+    const int len = encodeBatch<SpectralFeatures>(encoder, records, FEATURE_RECORDS, batch, sizeof(batch));
+    HOST_CHECK(TelemetryDecoder::decodeXorFeatures(batch, len, decoded, FEATURE_RECORDS) == FEATURE_RECORDS);
+    for (int i = 0; i < FEATURE_RECORDS; i++) {
+        HOST_CHECK(decoded[i].timestamp_us == records[i].timestamp_us);
+        HOST_CHECK(decoded[i].axis == records[i].axis);
+        float expected[XorFeaturesLayout::FIELDS];
+        float actual[XorFeaturesLayout::FIELDS];
+        XorFeaturesLayout::gatherFields(records[i], expected);
+        XorFeaturesLayout::gatherFields(decoded[i], actual);
+        HOST_CHECK(memcmp(expected, actual, sizeof(expected)) == 0);
+    }
+    HOST_CHECK(TelemetryDecoder::decodeXorFeatures(batch, len - 1, decoded, FEATURE_RECORDS) < 0);
+    printf("xor features: %d records in %d bytes (%d bytes raw)\n", FEATURE_RECORDS, len,
+        (int)(FEATURE_RECORDS * (sizeof(int64_t) + 1 + XorFeaturesLayout::FIELDS * sizeof(float))));
+}
+
+int main()
+{
+    testPackedEuler();
+    testDeltaEuler();
+    testXorFeatures();
+    return 0;
+}
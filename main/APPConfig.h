@@ -1,13 +1,85 @@
 #pragma once
+#include "sdkconfig.h"
 
 #define SSID "R9000P"
 // #define SSID "orangepi"
 #define PASSWORD "12345678"
 
 #define MQTT_BROKER_URL "mqtt://192.168.16.128:1883"
+#define MQTT_COMMAND_TOPIC "bno055/cmd" // JSON 命令，例如 {"fft_size":1024}、{"reset_baseline":true}、{"capture":true}
+// MQTT 批量发送：攒够条数、字节数或等待超过最长延迟即发出一批，条数设为 1 即逐条发送
+#define MQTT_BATCH_EULER_RECORDS 50
+#define MQTT_BATCH_EULER_BYTES 4096
+#define MQTT_BATCH_EULER_LATENCY_MS 500
+#define MQTT_BATCH_FEATURES_RECORDS 8
+#define MQTT_BATCH_FEATURES_BYTES 4096
+#define MQTT_BATCH_FEATURES_LATENCY_MS 2000
+// 二进制批次 (TelemetryEncoder.hpp) 发到 <主题>/packed，JSON 数组发到原主题
+#define MQTT_EULER_ENCODING 2 // 0: JSON，1: 定长二进制，2: 差分变长整数压缩
+#define MQTT_FEATURES_COMPRESSED 0 // 1: 频谱特征用 XOR 浮点压缩，0: JSON
+// 断网时发不出去的批次追加到 storage 分区上的分段日志，重连后限速补发，旧数据优先被淘汰
+#define SPOOL_DIR "/storage/spool"
+#define SPOOL_SEGMENT_BYTES (32 * 1024)
+#define SPOOL_MAX_SEGMENTS 16 // 最多占用 512KB，给基线文件留出空间
+#define SPOOL_REPLAY_PER_SEC 10 // 重连后每秒最多补发的批次数
+#define SPOOL_REPLAY_MAX_OUTBOX (16 * 1024) // outbox 超过该字节数时暂停补发，先让实时数据发出去
+
+// 生产者到消费者通道的溢出策略 (QueueChannel.hpp)：BLOCK / DROP_NEWEST / DROP_OLDEST / DECIMATE
+// 采集任务优先级最高，下游再慢也不能阻塞它，默认挤掉最旧的数据
+#define EULER_CHANNEL_DEPTH 256
+#define EULER_CHANNEL_OVERFLOW ChannelPolicy::DROP_OLDEST
+#define EULER_CHANNEL_TIMEOUT_MS 0 // 仅 BLOCK 使用，不要超过一个采样周期
+#define EULER_CHANNEL_DECIMATION 2 // 仅 DECIMATE 使用
+#define FEATURES_CHANNEL_DEPTH 8
+#define FEATURES_CHANNEL_OVERFLOW ChannelPolicy::DROP_OLDEST
+#define FEATURES_CHANNEL_TIMEOUT_MS 0
+#define CHANNEL_STATS_INTERVAL_MS 10000 // 有新的丢弃时按此间隔打印通道统计
+#define ACQUISITION_STATS_INTERVAL_MS 10000 // 采集任务按此间隔打印采样间隔抖动与寄存器影子缓存命中率，抖动统计每次打印后清零
+
+#define SENSOR_SAMPLE_RATE_HZ 100 // 采样率由 esp_timer 驱动，可设为 100/200/400/1000 等，不受 tick 限制
+#define VIBRATION_SAMPLE_RATE_HZ 1000 // 振动模式只读 6 字节加速度，400kHz I2C 下约 250us 一次
+#define N_SAMPLES 512 // 启动时的 FFT 点数，运行时可通过 MQTT 命令在最小与最大点数之间切换
+#define DSP_FFT_MIN_SAMPLES 256
+#if CONFIG_SPIRAM
+#define DSP_FFT_MAX_SAMPLES 4096 // 工作缓冲区按最大点数分配，放在 PSRAM
+#else
+#define DSP_FFT_MAX_SAMPLES 1024 // 没有 PSRAM 时内部 RAM 放不下更大的工作缓冲区
+#endif
+#define DSP_BLOCK_SAMPLES (N_SAMPLES / 4) // 采集任务交给 DSP 的块大小，也是 Welch 步进的最小粒度
+#define DSP_AXES 3 // DSP 分析的加速度轴数 (X/Y/Z)
+#define DSP_FFT_FIXED_POINT 0 // 1: 使用 int16 (sc16) FFT，Q15 窗与原始 s16 输入，DSP 缓冲区内存减半
+#define DSP_HPF_CUTOFF_HZ 1.0f // FFT 前高通截止频率，去除重力与直流，<= 0 关闭（仅浮点模式）
+#define DSP_DECIMATION 1 // FFT 前抽取比 1/2/4/8，用带宽换频率分辨率（仅浮点模式）
+#define DSP_Q15_INPUT_SHIFT 3 // 定点模式下输入左移的位数，加速度原始值不超过 12 位，留出 FFT 的动态范围
+#define WELCH_OVERLAP 0.5f // Welch 段间重叠率，0.75f 即 75% 重叠；步进按抽取后的点数换算并对齐到采集块，对不齐时打印实际重叠率
+#define WELCH_AVERAGING DSPEngine::WELCH_AVG_LINEAR // 或 DSPEngine::WELCH_AVG_EXPONENTIAL
+#define WELCH_AVERAGES 8
+#define DSP_MODE DSPEngine::MODE_CONTINUOUS // 或 DSPEngine::MODE_TONE_TRIGGERED，只监测已知频率，超阈值才做 FFT
+// 频率监测组的已知频率 { 频率 Hz, 幅值阈值 (峰值 m/s^2，<= 0 只监测不触发), 轴 0/1/2 }，至少一项，最多 TONE_BANK_MAX_TONES 项
+// 频率需低于抽取后采样率的一半；触发模式下没有任何一项设置阈值时退回连续模式
+#define DSP_TONES { { 25.0f, 0.5f, 2 } }
+#define BASELINE_LEARN_FRAMES 60 // 学满多少个平均谱后开始给出异常分数
+#define BASELINE_MAX_COUNT 256 // Welford 计数上限，之后按 1/256 的权重指数遗忘
+#define BASELINE_SAVE_FRAMES 60 // 基线每更新多少次写一次 LittleFS
+#define ANOMALY_SCORE_THRESHOLD 3.0f // 异常分数 (频点 z 值的均方根) 阈值
+#define ANOMALY_PEAK_Z_THRESHOLD 6.0f // 单个频点升高的 z 值阈值，捕捉只出现在少数频点上的新峰
+#define ANOMALY_REPORT_BY_EXCEPTION 1 // 1: 基线学完后只上报超过阈值的帧
+#define ENVELOPE_BAND_LOW_HZ 150.0f // 包络分析的共振带，需低于采集采样率的一半，否则不启用（仅浮点模式）
+#define ENVELOPE_BAND_HIGH_HZ 450.0f
+#define ENVELOPE_DECIMATION 8 // 包络抽取比 1/2/4/8/16，1000Hz 下包络谱范围 0 ~ 62.5Hz，分辨率 0.24Hz
+#define ENVELOPE_AVERAGES 4 // 包络谱指数平均的权重 1/ENVELOPE_AVERAGES
+#define CAPTURE_PRE_SAMPLES 512 // 波形捕获：触发前保留的样本数
+#define CAPTURE_POST_SAMPLES 512 // 触发后记录的样本数
+#define CAPTURE_SLOTS 2 // 捕获槽个数，上传未完成时槽用完则丢弃新的触发
+#define CAPTURE_THRESHOLD_MSQ 20.0f // 偏离均值的幅值阈值 (m/s^2)，<= 0 关闭
+#define CAPTURE_SLOPE_MSQ 0.0f // 相邻样本之差阈值 (m/s^2)，<= 0 关闭
+#define CAPTURE_RMS_JUMP_RATIO 3.0f // 一块的 RMS 超过长期 RMS 的倍数，<= 0 关闭
+#define CAPTURE_ON_ANOMALY 1 // 1: 频谱异常时也触发一次捕获
+#define SENSOR_ACQUISITION_PROFILE Bno055Driver::PROFILE_FUSION // 改为 PROFILE_VIBRATION 进入振动采集模式
 
 #define PRIO_SENSOR   tskIDLE_PRIORITY + 10
 #define PRIO_WIFI     tskIDLE_PRIORITY + 6
 #define PRIO_MQTT     tskIDLE_PRIORITY + 5
 #define PRIO_FFT      tskIDLE_PRIORITY + 4
+#define PRIO_CAPTURE_UPLOAD tskIDLE_PRIORITY + 2
 #define PRIO_LED      tskIDLE_PRIORITY + 1
\ No newline at end of file
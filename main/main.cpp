@@ -11,15 +11,17 @@
 #include "WifiTask.hpp"
 #include "WifiStation.hpp"
 #include "DSPEngine.hpp"
+#include "Storage.hpp"
+#include "SegmentLog.hpp"
+#include "CaptureUploadTask.hpp"
 
 static constexpr auto TAG = "main";
 
 extern "C" void app_main()
 {
     //  创建bno055对象以及相关任务
-    auto bno055 = std::make_shared<Bno055Driver>();
-    auto bno055_read_euler_task = std::make_unique<Bno055ReadEulerTask>(bno055);
-    auto bno055_read_liner_acc_z_task = std::make_unique<Bno055ReadLinerAccZTask>(bno055);
+    auto bno055 = std::make_shared<Bno055Driver>(SENSOR_ACQUISITION_PROFILE);
+    auto bno055_acquisition_task = std::make_unique<Bno055AcquisitionTask>(bno055);
     // 创建两个led对象，以及相关任务
     std::vector<std::shared_ptr<LED>> led_list;
     auto red_led = std::make_shared<LED>(LED_RED);
@@ -27,20 +29,27 @@ extern "C" void app_main()
     led_list.push_back(std::move(red_led));
     led_list.push_back(std::move(green_led));
     auto led_task = std::make_unique<LEDTask>(std::move(led_list));
+    // 创建DSP引擎对象以及相关任务
+    auto dsp_engine = std::make_shared<DSPEngine>(bno055);
+    static const ToneSpec dsp_tones[] = DSP_TONES; // 频率监测组需在 start() 之前配置
+    dsp_engine->setTones(dsp_tones, sizeof(dsp_tones) / sizeof(dsp_tones[0]));
     // 创建MQTT对象和相关任务
     auto mqtt_client = std::make_shared<MQTTClient>();
-    auto mqtt_task = std::make_shared<MQTTTask>(mqtt_client, bno055);
+    auto spool = std::make_shared<SegmentLog>(SPOOL_DIR, SPOOL_SEGMENT_BYTES, SPOOL_MAX_SEGMENTS);
+    auto mqtt_task = std::make_shared<MQTTTask>(mqtt_client, bno055, dsp_engine, spool);
     auto mqtt_notify_start_task = std::make_shared<MQTTNotifyStartTask>(mqtt_client);
     auto mqtt_notify_stop_task = std::make_shared<MQTTNotifyStopTask>(mqtt_client);
+    auto capture_upload_task = std::make_unique<CaptureUploadTask>(mqtt_client, dsp_engine);
     // 创建Wifi对象以及相关任务
     auto wifi_station = std::make_unique<WifiStation>(mqtt_task, mqtt_notify_start_task, mqtt_notify_stop_task);
     auto wifi_task = std::make_unique<WifiTask>(std::move(wifi_station));
-    // 创建DSP引擎对象以及相关任务
-    auto dsp_engine = std::make_shared<DSPEngine>(bno055);
+
+    // 挂载 LittleFS，DSP 引擎启动时从中读取频谱基线，MQTT 断网时把数据暂存在其中
+    Storage::mount();
+    spool->open();
 
     // 任务启动
-    bno055_read_euler_task->start();
-    bno055_read_liner_acc_z_task->start();
+    bno055_acquisition_task->start();
     
     led_task->start();
 
@@ -51,6 +60,7 @@ extern "C" void app_main()
     mqtt_notify_stop_task->start();
 
     dsp_engine->start();
+    capture_upload_task->start();
     
     while (1) {
         vTaskDelay(pdMS_TO_TICKS(6000));